@@ -0,0 +1,69 @@
+TEMPLATE = app
+TARGET   = ColorLines
+
+QT += quick sql
+
+CONFIG += c++11
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+        boarditem.cpp \
+        database.cpp \
+        gameboard.cpp \
+        gamerestorer.cpp \
+        highscoremodel.cpp \
+        hintworker.cpp \
+        journalindex.cpp \
+        main.cpp \
+        palette.cpp \
+        persistenceworker.cpp \
+        scoretable.cpp \
+        snapshotstorage.cpp \
+        sqlitestorage.cpp \
+        startuploader.cpp \
+        startupmetrics.cpp \
+        storagebackend.cpp \
+        structs.cpp \
+        turnworker.cpp
+
+RESOURCES += qml.qrc
+
+# Additional import path used to resolve QML modules in Qt Creator's code model
+QML_IMPORT_PATH =
+
+# Additional import path used to resolve QML modules just for Qt Quick Designer
+QML_DESIGNER_IMPORT_PATH =
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+HEADERS += \
+    boarditem.h \
+    database.h \
+    gameboard.h \
+    gamerestorer.h \
+    highscoremodel.h \
+    hintworker.h \
+    journalindex.h \
+    palette.h \
+    persistenceworker.h \
+    scoretable.h \
+    snapshotstorage.h \
+    spscqueue.h \
+    sqlitestorage.h \
+    startuploader.h \
+    startupmetrics.h \
+    storagebackend.h \
+    structs.h \
+    turnworker.h
+
+# make check: offscreen smoke test of the board rendering on both scene graph backends
+check.commands = sh $$PWD/grab-check.sh $$OUT_PWD/$$TARGET
+QMAKE_EXTRA_TARGETS += check
+
+include(../engine/engine.pri)
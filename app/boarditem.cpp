@@ -0,0 +1,628 @@
+#include "boarditem.h"
+
+#include <QImage>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGImageNode>
+#include <QSGRendererInterface>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+
+#include <memory>
+#include <vector>
+
+#include "tracer.h"
+
+namespace {
+
+const int   APPEAR_MS      = 500;    // как animDuration прежнего Cell.qml
+const int   MOVE_MS        = 1000;   // весь путь фигуры
+const int   MIN_SEGMENT_MS = 40;
+const float PIECE_SCALE    = 0.6f;   // диаметр фигуры от стороны ячейки: 30 при ячейке 50
+const float CELL_BORDER    = 1;
+const float HINT_BORDER    = 3;
+
+const QRgb BORDER_RGB     = 0xFFA52A2A;   // brown
+const QRgb HINT_RGB       = 0xFFFFD700;   // gold
+const QRgb BACKGROUND_RGB = 0xFFFFFFFF;
+
+const int CELL_VERTICES = 12;   // рамка и фон ячейки: два прямоугольника по два треугольника
+const int TILE_SIDE     = 8;    // сторона плитки поля в ячейках
+
+/**
+ * Узел поля на графическом процессоре: по узлу с постоянным массивом вершин на плитку
+ * и последним - узел перемещаемой фигуры, чтобы она рисовалась поверх плиток
+ */
+class BoardGeometryNode : public QSGNode {
+public:
+    QVector<QSGGeometryNode*> tiles;
+    QSGGeometryNode*          moving        = nullptr;
+    bool                      isMovingShown = false;
+};
+
+/**
+ * Узел программного рендера: у каждой плитки свое изображение и своя текстура,
+ * у перемещаемой фигуры - отдельное изображение, которое только сдвигается
+ */
+class BoardTextureNode : public QSGNode {
+public:
+    struct Tile {
+        QSGImageNode*               node = nullptr;
+        QImage                      image;
+        std::unique_ptr<QSGTexture> texture;
+    };
+
+    void setTexture(Tile& tile, QSGTexture* newTexture) {
+        tile.node->setTexture(newTexture);
+        tile.texture.reset(newTexture);
+    }
+
+    std::vector<Tile> tiles;
+    Tile              moving;
+    QRgb              movingColor = 0;
+};
+
+QSGGeometryNode* createColoredNode(int vertexCount) {
+    QSGGeometryNode* node = new QSGGeometryNode();
+    QSGGeometry* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), vertexCount);
+    geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(new QSGVertexColorMaterial());
+    node->setFlag(QSGNode::OwnsMaterial);
+    return node;
+}
+
+QPointF eventPosition(const QMouseEvent* event) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return event->position();
+#else
+    return event->localPos();
+#endif
+}
+
+/**
+ * @brief setVertex
+ * Записывает вершину с цветом color, умноженным на прозрачность (материал ждет
+ * цвета с предумноженной альфой)
+ */
+void setVertex(QSGGeometry::ColoredPoint2D& vertex, float x, float y, QRgb color, qreal opacity) {
+    const int alpha = qRound(qAlpha(color) * opacity);
+    vertex.set(x, y, uchar(qRed(color) * alpha / 255), uchar(qGreen(color) * alpha / 255),
+               uchar(qBlue(color) * alpha / 255), uchar(alpha));
+}
+
+void writeQuad(QSGGeometry::ColoredPoint2D* vertices, const QRectF& rect, QRgb color) {
+    const float left = float(rect.left());
+    const float top = float(rect.top());
+    const float right = float(rect.right());
+    const float bottom = float(rect.bottom());
+    setVertex(vertices[0], left, top, color, 1);
+    setVertex(vertices[1], right, top, color, 1);
+    setVertex(vertices[2], left, bottom, color, 1);
+    setVertex(vertices[3], right, top, color, 1);
+    setVertex(vertices[4], right, bottom, color, 1);
+    setVertex(vertices[5], left, bottom, color, 1);
+}
+
+void clearVertices(QSGGeometry::ColoredPoint2D* vertices, int count) {
+    for (int i = 0; i < count; ++i)
+        vertices[i].set(0, 0, 0, 0, 0, 0);
+}
+
+} // namespace
+
+BoardItem::BoardItem(QQuickItem *parent)
+    : QQuickItem(parent) {
+    setFlag(ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    moveTimer.setSingleShot(true);
+    connect(&moveTimer, &QTimer::timeout, this, &BoardItem::finishMove);
+    connect(this, &QQuickItem::widthChanged, this, &BoardItem::relayout);
+    connect(this, &QQuickItem::heightChanged, this, &BoardItem::relayout);
+    clock.start();
+}
+
+GameBoard* BoardItem::board() const {
+    return m_board;
+}
+
+/**
+ * @brief BoardItem::setBoard
+ * Подключается к уведомлениям модели: измененные ячейки, сброс, размер поля и подсказка
+ */
+void BoardItem::setBoard(GameBoard* newBoard) {
+    if (m_board == newBoard)
+        return;
+    if (m_board)
+        disconnect(m_board.data(), nullptr, this, nullptr);
+    m_board = newBoard;
+    if (m_board) {
+        connect(m_board.data(), &QAbstractItemModel::dataChanged, this, &BoardItem::cellsChanged);
+        connect(m_board.data(), &QAbstractItemModel::modelReset, this, &BoardItem::reloadCells);
+        connect(m_board.data(), &GameBoard::geometryChanged, this, &BoardItem::reloadCells);
+        connect(m_board.data(), &GameBoard::hintChanged, this, &BoardItem::hintMoved);
+        connect(m_board.data(), &GameBoard::moveResolved, this, &BoardItem::moveResolved);
+        connect(m_board.data(), &GameBoard::turnBusyChanged, this, &BoardItem::turnBusyChanged);
+    }
+    reloadCells();
+    hintMoved();
+    emit boardChanged();
+}
+
+bool BoardItem::isMoving() const {
+    return m_isMoving;
+}
+
+/**
+ * @brief BoardItem::clearSelection
+ * Забывает выбранную первым щелчком фигуру, например после отмены хода
+ */
+void BoardItem::clearSelection() {
+    hasSelection = false;
+}
+
+/**
+ * @brief BoardItem::cellsChanged
+ * Перечитывает ячейки диапазона; появление и исчезновение фигуры запускают анимацию.
+ * Освободившаяся ячейка сохраняет цвет снятой фигуры, чтобы та исчезала постепенно
+ */
+void BoardItem::cellsChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+    const int last = qMin(bottomRight.row(), cells.size() - 1);
+    for (int i = qMax(0, topLeft.row()); i <= last; ++i) {
+        CellView view;
+        readCell(i, view);
+        CellView& shown = cells[i];
+        if (view.isBusy != shown.isBusy)
+            startAnimation(i, view.isBusy ? APPEAR : FADE);
+        if (view.isBusy)
+            shown.color = view.color;
+        shown.isBusy = view.isBusy;
+        markDirty(i);
+    }
+    update();
+}
+
+/**
+ * @brief BoardItem::reloadCells
+ * Перечитывает все поле без анимации: новая партия, восстановление или смена размера
+ */
+void BoardItem::reloadCells() {
+    rows = m_board ? m_board->rows() : 0;
+    columns = m_board ? m_board->columns() : 0;
+    cells.fill(CellView(), rows * columns);
+    tileRows = (rows + TILE_SIDE - 1) / TILE_SIDE;
+    tileColumns = (columns + TILE_SIDE - 1) / TILE_SIDE;
+    for (int i = 0; i < cells.size(); ++i)
+        readCell(i, cells[i]);
+    dirtyCells.fill(true, cells.size());
+    animatedCells.clear();
+    hasSelection = false;
+    relayout();
+}
+
+void BoardItem::hintMoved() {
+    markDirty(shownHintFrom);
+    markDirty(shownHintTo);
+    shownHintFrom = m_board ? m_board->hintFrom() : -1;
+    shownHintTo = m_board ? m_board->hintTo() : -1;
+    markDirty(shownHintFrom);
+    markDirty(shownHintTo);
+    update();
+}
+
+/**
+ * @brief BoardItem::relayout
+ * Пересчитывает сторону ячейки по размеру элемента и число сегментов окружности фигуры
+ */
+void BoardItem::relayout() {
+    cellSize = 0;
+    if (rows > 0 && columns > 0)
+        cellSize = qFloor(qMin(width() / columns, height() / rows));
+    const float radius = cellSize * PIECE_SCALE / 2;
+    segments = qBound(8, int(radius) + 6, 32);
+    circleX.resize(segments + 1);
+    circleY.resize(segments + 1);
+    for (int i = 0; i <= segments; ++i) {
+        const qreal angle = 2 * M_PI * i / segments;
+        circleX[i] = float(qCos(angle));
+        circleY[i] = float(qSin(angle));
+    }
+    isLayoutDirty = true;
+    update();
+}
+
+void BoardItem::mousePressEvent(QMouseEvent* event) {
+    if (event->button() != Qt::LeftButton || cellAtPoint(eventPosition(event)) < 0) {
+        event->ignore();
+        return;
+    }
+    event->accept();
+}
+
+/**
+ * @brief BoardItem::mouseReleaseEvent
+ * Щелчок засчитывается, как у MouseArea, по отпусканию кнопки над ячейкой поля
+ */
+void BoardItem::mouseReleaseEvent(QMouseEvent* event) {
+    int index = cellAtPoint(eventPosition(event));
+    if (index >= 0)
+        cellClicked(index);
+    event->accept();
+}
+
+/**
+ * @brief BoardItem::cellAtPoint
+ * * @return индекс ячейки под точкой элемента, либо -1 вне поля
+ */
+int BoardItem::cellAtPoint(const QPointF& point) const {
+    if (cellSize <= 0 || point.x() < 0 || point.y() < 0)
+        return -1;
+    int column = int(point.x() / cellSize);
+    int row = int(point.y() / cellSize);
+    if (column >= columns || row >= rows)
+        return -1;
+    return row * columns + column;
+}
+
+/**
+ * @brief BoardItem::cellClicked
+ * Первый щелчок выбирает фигуру, второй - ячейку, куда она пойдет. Ход разыгрывается
+ * в фоне, анимация начнется по moveResolved. Выбор сбрасывается в любом случае
+ */
+void BoardItem::cellClicked(int index) {
+    if (!m_board || m_isMoving)
+        return;
+    TRACE_SPAN("BoardItem::cellClicked");
+    if (!hasSelection) {
+        hasSelection = m_board->tryToMakeAFirstMove(index);
+        return;
+    }
+    hasSelection = false;
+    m_board->tryToMakeASecondMove(index);
+}
+
+void BoardItem::moveResolved(bool isMoved) {
+    if (isMoved)
+        startMove(m_board->lastMovePath());
+}
+
+/**
+ * @brief BoardItem::turnBusyChanged
+ * Ход, отмененный моделью (например, новой партией), больше не анимируется
+ */
+void BoardItem::turnBusyChanged() {
+    if (!m_isMoving || m_board->turnBusy())
+        return;
+    moveTimer.stop();
+    m_isMoving = false;
+    markDirty(movePath.last());
+    movePath.clear();
+    emit isMovingChanged();
+    update();
+}
+
+/**
+ * @brief BoardItem::startMove
+ * Ведет фигуру по пути хода: каждый отрезок между соседними ячейками занимает равную
+ * долю секунды. По окончании ход завершает endASecondMove
+ */
+void BoardItem::startMove(const QVector<int>& path) {
+    if (path.size() < 2) {
+        m_board->endASecondMove();
+        return;
+    }
+    // фигура уже перенесена моделью: концы пути рисует перемещение, а не появление и исчезновение
+    for (int end : {path.first(), path.last()}) {
+        cells[end].animation = NONE;
+        markDirty(end);
+    }
+    movePath = path;
+    segmentMs = qMax(MIN_SEGMENT_MS, MOVE_MS / (path.size() - 1));
+    moveStart = clock.elapsed();
+    m_isMoving = true;
+    moveTimer.start(segmentMs * (path.size() - 1));
+    emit isMovingChanged();
+    update();
+}
+
+void BoardItem::finishMove() {
+    if (!m_isMoving)
+        return;
+    const int index = movePath.last();
+    m_isMoving = false;
+    markDirty(index);
+    emit isMovingChanged();
+    update();
+    movePath.clear();
+    if (m_board)
+        m_board->endASecondMove();
+}
+
+void BoardItem::markDirty(int index) {
+    if (index >= 0 && index < dirtyCells.size())
+        dirtyCells.setBit(index);
+}
+
+void BoardItem::readCell(int index, CellView& view) const {
+    const QModelIndex modelIndex = m_board->index(index, 0);
+    view.color = m_board->data(modelIndex, GameBoard::cellColor).value<QColor>().rgba();
+    view.isBusy = m_board->data(modelIndex, GameBoard::cellIsBusy).toBool();
+}
+
+void BoardItem::startAnimation(int index, Animation animation) {
+    CellView& view = cells[index];
+    if (view.animation == NONE)
+        animatedCells.append(index);
+    view.animation = animation;
+    view.animationStart = clock.elapsed();
+}
+
+/**
+ * @brief BoardItem::advanceAnimations
+ * Помечает для перерисовки ячейки с идущей анимацией и снимает закончившиеся
+ * * @return true, если анимации еще идут и нужен следующий кадр
+ */
+bool BoardItem::advanceAnimations(qint64 now) {
+    for (int i = animatedCells.size() - 1; i >= 0; --i) {
+        const int index = animatedCells[i];
+        CellView& view = cells[index];
+        markDirty(index);
+        if (view.animation != NONE && now - view.animationStart < APPEAR_MS)
+            continue;
+        view.animation = NONE;
+        animatedCells.remove(i);
+    }
+    return !animatedCells.isEmpty();
+}
+
+qreal BoardItem::pieceOpacity(const CellView& view, qint64 now) const {
+    if (qAlpha(view.color) == 0)
+        return 0;
+    const qreal progress = qBound(qreal(0), qreal(now - view.animationStart) / APPEAR_MS, qreal(1));
+    switch (view.animation) {
+    case APPEAR:
+        return progress;
+    case FADE:
+        return 1 - progress;
+    }
+    return view.isBusy ? 1 : 0;
+}
+
+/**
+ * @brief BoardItem::movingCenter
+ * * @return центр перемещаемой фигуры: на отрезке пути, соответствующем времени now
+ */
+QPointF BoardItem::movingCenter(qint64 now) const {
+    const int last = movePath.size() - 2;
+    const qint64 elapsed = qMax(qint64(0), now - moveStart);
+    const int segment = qMin(int(elapsed / segmentMs), last);
+    const qreal progress = qMin(qreal(1), qreal(elapsed - qint64(segment) * segmentMs) / segmentMs);
+    const QPointF from = cellRect(movePath[segment]).center();
+    const QPointF to = cellRect(movePath[segment + 1]).center();
+    return from + (to - from) * progress;
+}
+
+QRectF BoardItem::cellRect(int index) const {
+    return QRectF((index % columns) * cellSize, (index / columns) * cellSize, cellSize, cellSize);
+}
+
+/**
+ * @brief BoardItem::tileArea
+ * * @return столбцы и строки ячеек плитки; крайние плитки могут быть меньше TILE_SIDE
+ */
+QRect BoardItem::tileArea(int tile) const {
+    const int column = (tile % tileColumns) * TILE_SIDE;
+    const int row = (tile / tileColumns) * TILE_SIDE;
+    return QRect(column, row, qMin(TILE_SIDE, columns - column), qMin(TILE_SIDE, rows - row));
+}
+
+QSGNode* BoardItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) {
+    Q_UNUSED(data);
+    TRACE_SPAN("BoardItem::updatePaintNode");
+    if (cells.isEmpty() || cellSize < 1) {
+        delete oldNode;
+        isLayoutDirty = true;
+        return nullptr;
+    }
+    // плитки строятся под размер поля и ячейки, поэтому новая раскладка - новые узлы
+    if (isLayoutDirty) {
+        delete oldNode;
+        oldNode = nullptr;
+    }
+    const qint64 now = clock.elapsed();
+    bool isAnimating = advanceAnimations(now);
+    QSGNode* node;
+    if (window()->rendererInterface()->graphicsApi() == QSGRendererInterface::Software)
+        node = updateImageNode(oldNode, now);
+    else
+        node = updateGeometryNode(oldNode, now);
+    dirtyCells.fill(false);
+    isLayoutDirty = false;
+    if (isAnimating || m_isMoving)
+        update();
+    return node;
+}
+
+/**
+ * @brief BoardItem::updateGeometryNode
+ * Поле - узлы плиток по TILE_SIDE x TILE_SIDE ячеек. Массивы вершин выделяются один раз
+ * на раскладку, у каждой ячейки постоянное место в массиве своей плитки (рамка, фон, обвод
+ * и заливка фигуры). Переписываются вершины только измененных ячеек, и только их плитки
+ * передаются заново; невидимая фигура сводится в точку. Перемещаемая фигура - свой узел
+ */
+QSGNode* BoardItem::updateGeometryNode(QSGNode* oldNode, qint64 now) {
+    const int discVertices = segments * 3;
+    const int cellVertices = CELL_VERTICES + 2 * discVertices;
+    BoardGeometryNode* node = static_cast<BoardGeometryNode*>(oldNode);
+    if (!node) {
+        node = new BoardGeometryNode();
+        for (int tile = 0; tile < tileRows * tileColumns; ++tile) {
+            const QRect area = tileArea(tile);
+            node->tiles.append(createColoredNode(cellVertices * area.width() * area.height()));
+            node->appendChildNode(node->tiles.last());
+        }
+        node->moving = createColoredNode(2 * discVertices);
+        clearVertices(node->moving->geometry()->vertexDataAsColoredPoint2D(), 2 * discVertices);
+        node->appendChildNode(node->moving);
+        dirtyCells.fill(true);
+    }
+    const float radius = cellSize * PIECE_SCALE / 2;
+
+    auto writeDisc = [&](QSGGeometry::ColoredPoint2D* out, const QPointF& center, float discRadius,
+                         QRgb color, qreal opacity) {
+        const float x = float(center.x());
+        const float y = float(center.y());
+        for (int s = 0; s < segments; ++s) {
+            setVertex(out[3 * s], x, y, color, opacity);
+            setVertex(out[3 * s + 1], x + discRadius * circleX[s], y + discRadius * circleY[s], color, opacity);
+            setVertex(out[3 * s + 2], x + discRadius * circleX[s + 1], y + discRadius * circleY[s + 1],
+                      color, opacity);
+        }
+    };
+    auto writePiece = [&](QSGGeometry::ColoredPoint2D* out, const QPointF& center, QRgb color, qreal opacity) {
+        if (opacity <= 0) {
+            clearVertices(out, 2 * discVertices);
+            return;
+        }
+        writeDisc(out, center, radius, BORDER_RGB, opacity);
+        writeDisc(out + discVertices, center, qMax(0.0f, radius - CELL_BORDER), color, opacity);
+    };
+
+    for (int tile = 0; tile < node->tiles.size(); ++tile) {
+        const QRect area = tileArea(tile);
+        QSGGeometryNode* tileNode = node->tiles[tile];
+        QSGGeometry::ColoredPoint2D* out = tileNode->geometry()->vertexDataAsColoredPoint2D();
+        bool isTileChanged = false;
+        for (int row = area.top(); row <= area.bottom(); ++row) {
+            for (int column = area.left(); column <= area.right(); ++column, out += cellVertices) {
+                const int i = row * columns + column;
+                if (!dirtyCells.testBit(i))
+                    continue;
+                isTileChanged = true;
+                const QRectF rect = cellRect(i);
+                const bool isHint = i == shownHintFrom || i == shownHintTo;
+                const float border = isHint ? HINT_BORDER : CELL_BORDER;
+                writeQuad(out, rect, isHint ? HINT_RGB : BORDER_RGB);
+                writeQuad(out + 6, rect.adjusted(border, border, -border, -border), BACKGROUND_RGB);
+                const bool isMovingHere = m_isMoving && i == movePath.last();
+                writePiece(out + CELL_VERTICES, rect.center(), cells[i].color,
+                           isMovingHere ? 0 : pieceOpacity(cells[i], now));
+            }
+        }
+        if (isTileChanged)
+            tileNode->markDirty(QSGNode::DirtyGeometry);
+    }
+    QSGGeometry::ColoredPoint2D* moving = node->moving->geometry()->vertexDataAsColoredPoint2D();
+    if (m_isMoving)
+        writePiece(moving, movingCenter(now), cells[movePath.last()].color, 1);
+    else if (node->isMovingShown)
+        clearVertices(moving, 2 * discVertices);
+    if (m_isMoving || node->isMovingShown)
+        node->moving->markDirty(QSGNode::DirtyGeometry);
+    node->isMovingShown = m_isMoving;
+    return node;
+}
+
+/**
+ * @brief BoardItem::updateImageNode
+ * Программный рендер: у каждой плитки постоянное изображение, в котором перерисовываются
+ * только изменившиеся ячейки, и текстура создается заново только для таких плиток.
+ * Перемещаемая фигура рисуется один раз в свое изображение и в каждом кадре только сдвигается
+ */
+QSGNode* BoardItem::updateImageNode(QSGNode* oldNode, qint64 now) {
+    BoardTextureNode* node = static_cast<BoardTextureNode*>(oldNode);
+    if (!node) {
+        node = new BoardTextureNode();
+        imageScale = window()->effectiveDevicePixelRatio();
+        node->tiles.resize(size_t(tileRows * tileColumns));
+        for (int tile = 0; tile < tileRows * tileColumns; ++tile) {
+            const QRect area = tileArea(tile);
+            BoardTextureNode::Tile& tileView = node->tiles[size_t(tile)];
+            tileView.node = window()->createImageNode();
+            tileView.node->setRect(QRectF(area.left() * cellSize, area.top() * cellSize,
+                                          area.width() * cellSize, area.height() * cellSize));
+            tileView.image = QImage(qCeil(area.width() * cellSize * imageScale),
+                                    qCeil(area.height() * cellSize * imageScale),
+                                    QImage::Format_ARGB32_Premultiplied);
+            tileView.image.fill(Qt::transparent);
+            node->appendChildNode(tileView.node);
+        }
+        dirtyCells.fill(true);
+    }
+
+    for (int tile = 0; tile < tileRows * tileColumns; ++tile) {
+        const QRect area = tileArea(tile);
+        BoardTextureNode::Tile& tileView = node->tiles[size_t(tile)];
+        QPainter painter;
+        for (int row = area.top(); row <= area.bottom(); ++row) {
+            for (int column = area.left(); column <= area.right(); ++column) {
+                const int i = row * columns + column;
+                if (!dirtyCells.testBit(i))
+                    continue;
+                if (!painter.isActive()) {
+                    painter.begin(&tileView.image);
+                    painter.setRenderHint(QPainter::Antialiasing);
+                    painter.scale(imageScale, imageScale);
+                    painter.translate(-area.left() * cellSize, -area.top() * cellSize);
+                }
+                paintCell(painter, i, now);
+            }
+        }
+        if (!painter.isActive())
+            continue;
+        painter.end();
+        node->setTexture(tileView, window()->createTextureFromImage(tileView.image));
+    }
+
+    const qreal radius = cellSize * PIECE_SCALE / 2 + CELL_BORDER;
+    if (m_isMoving && (!node->moving.node || node->movingColor != cells[movePath.last()].color)) {
+        if (!node->moving.node) {
+            node->moving.node = window()->createImageNode();
+            node->appendChildNode(node->moving.node);
+        }
+        node->movingColor = cells[movePath.last()].color;
+        node->moving.image = QImage(qCeil(2 * radius * imageScale), qCeil(2 * radius * imageScale),
+                                    QImage::Format_ARGB32_Premultiplied);
+        node->moving.image.fill(Qt::transparent);
+        QPainter painter(&node->moving.image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.scale(imageScale, imageScale);
+        paintPiece(painter, QPointF(radius, radius), node->movingColor, 1);
+        painter.end();
+        node->setTexture(node->moving, window()->createTextureFromImage(node->moving.image));
+    }
+    if (node->moving.node) {
+        const QPointF center = m_isMoving ? movingCenter(now) : QPointF();
+        node->moving.node->setRect(m_isMoving ? QRectF(center.x() - radius, center.y() - radius,
+                                                       2 * radius, 2 * radius)
+                                              : QRectF());
+    }
+    return node;
+}
+
+void BoardItem::paintCell(QPainter& painter, int index, qint64 now) {
+    const QRectF rect = cellRect(index);
+    const bool isHint = index == shownHintFrom || index == shownHintTo;
+    const qreal border = isHint ? HINT_BORDER : CELL_BORDER;
+    painter.save();
+    painter.setClipRect(rect);
+    painter.fillRect(rect, QColor::fromRgba(isHint ? HINT_RGB : BORDER_RGB));
+    painter.fillRect(rect.adjusted(border, border, -border, -border), QColor::fromRgba(BACKGROUND_RGB));
+    const bool isMovingHere = m_isMoving && index == movePath.last();
+    const qreal opacity = isMovingHere ? 0 : pieceOpacity(cells[index], now);
+    if (opacity > 0)
+        paintPiece(painter, rect.center(), cells[index].color, opacity);
+    painter.restore();
+}
+
+void BoardItem::paintPiece(QPainter& painter, const QPointF& center, QRgb color, qreal opacity) {
+    const qreal radius = cellSize * PIECE_SCALE / 2;
+    painter.setOpacity(opacity);
+    painter.setPen(QPen(QColor::fromRgba(BORDER_RGB), CELL_BORDER));
+    painter.setBrush(QColor::fromRgba(color));
+    painter.drawEllipse(center, radius - CELL_BORDER / 2, radius - CELL_BORDER / 2);
+    painter.setOpacity(1);
+}
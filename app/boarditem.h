@@ -0,0 +1,118 @@
+#ifndef BOARDITEM_H
+#define BOARDITEM_H
+
+#include <QBitArray>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QQuickItem>
+#include <QRect>
+#include <QTimer>
+#include <QVector>
+
+#include "gameboard.h"
+
+/**
+ * Поле целиком одним элементом сцены вместо делегатов на каждую ячейку.
+ * Состояние ячеек берется из модели GameBoard и обновляется по ее dataChanged только
+ * для изменившихся ячеек. Элемент сам определяет ячейку под щелчком, выполняет
+ * первый и второй щелчок хода и анимирует перемещение фигуры, ее появление и исчезновение.
+ * Поле разбито на плитки: на графическом процессоре каждая плитка - QSGGeometryNode
+ * с цветами в вершинах. Программный рендер Qt Quick узлы с произвольной геометрией не рисует,
+ * поэтому с ним каждая плитка рисуется QPainter в свое изображение. В обоих случаях кадр
+ * передает заново только плитки с изменившимися ячейками
+ */
+class BoardItem : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(GameBoard* board    READ board    WRITE setBoard NOTIFY boardChanged)
+    Q_PROPERTY(bool       isMoving READ isMoving                NOTIFY isMovingChanged)
+public:
+    explicit BoardItem(QQuickItem *parent = nullptr);
+
+    GameBoard* board() const;
+    void       setBoard(GameBoard* newBoard);
+    bool       isMoving() const;
+
+    Q_INVOKABLE void clearSelection();
+
+signals:
+    void boardChanged();
+    void isMovingChanged();
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void     mousePressEvent(QMouseEvent* event) override;
+    void     mouseReleaseEvent(QMouseEvent* event) override;
+
+private slots:
+    void cellsChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void reloadCells();
+    void hintMoved();
+    void relayout();
+    void moveResolved(bool isMoved);
+    void turnBusyChanged();
+    void finishMove();
+
+private:
+    enum Animation {
+        NONE,
+        APPEAR,
+        FADE
+    };
+
+    struct CellView {
+        QRgb   color          = 0;
+        bool   isBusy         = false;
+        quint8 animation      = NONE;
+        qint64 animationStart = 0;
+    };
+
+    QPointer<GameBoard> m_board;
+    int                 rows    = 0;
+    int                 columns = 0;
+    QVector<CellView>   cells;
+
+    QBitArray    dirtyCells;
+    QVector<int> animatedCells;
+    bool         isLayoutDirty = true;
+    int          shownHintFrom = -1;
+    int          shownHintTo   = -1;
+
+    bool         hasSelection = false;
+    bool         m_isMoving   = false;
+    QVector<int> movePath;
+    qint64       moveStart    = 0;
+    int          segmentMs    = 0;
+    QTimer       moveTimer;
+
+    QElapsedTimer clock;
+
+    // раскладка, вычисляемая при смене размера
+    int            tileRows    = 0;
+    int            tileColumns = 0;
+    float          cellSize    = 0;
+    int            segments    = 0;
+    QVector<float> circleX;
+    QVector<float> circleY;
+
+    // программный рендер: масштаб изображений плиток в пиксели устройства
+    qreal imageScale = 1;
+
+    int  cellAtPoint(const QPointF& point) const;
+    void cellClicked(int index);
+    void startMove(const QVector<int>& path);
+    void markDirty(int index);
+    void readCell(int index, CellView& view) const;
+    void startAnimation(int index, Animation animation);
+    bool advanceAnimations(qint64 now);
+    qreal pieceOpacity(const CellView& view, qint64 now) const;
+    QPointF movingCenter(qint64 now) const;
+    QRectF  cellRect(int index) const;
+    QRect   tileArea(int tile) const;
+
+    QSGNode* updateGeometryNode(QSGNode* oldNode, qint64 now);
+    QSGNode* updateImageNode(QSGNode* oldNode, qint64 now);
+    void     paintCell(QPainter& painter, int index, qint64 now);
+    void     paintPiece(QPainter& painter, const QPointF& center, QRgb color, qreal opacity);
+};
+
+#endif // BOARDITEM_H
@@ -0,0 +1,336 @@
+#include "database.h"
+
+#include <QDateTime>
+
+#include "journalindex.h"
+#include "tracer.h"
+
+DataBase::~DataBase() {
+    stopWriter();
+    delete reader;
+}
+
+DataBase::DataBase(QObject *parent)
+    : QObject(parent) {
+}
+
+/**
+ * @brief DataBase::setStorageType
+ * Выбирает формат хранения. Действует только до вызова connectToDB
+ */
+void DataBase::setStorageType(StorageType type) {
+    storageType = type;
+}
+
+StorageType DataBase::getStorageType() const {
+    return storageType;
+}
+
+/**
+ * @brief DataBase::connectToDB
+ * Запускает писателя. Соединение чтения откроется при первом чтении
+ */
+void DataBase::connectToDB() {
+    qDebug() << "connectToDB: " << storageName(storageType);
+    startWriter();
+}
+
+/**
+ * @brief DataBase::openReader
+ * Дописывает очередь писателя и при первом вызове открывает соединение чтения
+ * * @return хранилище для чтения в потоке интерфейса
+ */
+StorageBackend* DataBase::openReader() {
+    flushAndWait();
+    if (!reader) {
+        TRACE_SPAN("DataBase::openReader");
+        reader = createStorageBackend(storageType, READER_CONNECTION);
+        reader->open();
+    }
+    return reader;
+}
+
+/**
+ * @brief DataBase::startWriter
+ * Запускает фоновый поток писателя со своим экземпляром хранилища
+ */
+void DataBase::startWriter() {
+    writer = new PersistenceWorker(&writeQueue, storageType, NAME_JOURNAL, NAME_SCORES);
+    writer->moveToThread(&writerThread);
+    connect(&writerThread, &QThread::started, writer, &PersistenceWorker::start);
+    connect(&writerThread, &QThread::finished, writer, &QObject::deleteLater);
+    connect(writer, &PersistenceWorker::flushed, this, &DataBase::onFlushed);
+    writerThread.start();
+}
+
+/**
+ * @brief DataBase::stopWriter
+ * Гарантирует запись всех изменений и останавливает поток писателя
+ */
+void DataBase::stopWriter() {
+    if (!writer)
+        return;
+    commitTurn();
+    flushAndWait();
+    QMetaObject::invokeMethod(writer, "stop", Qt::BlockingQueuedConnection);
+    writerThread.quit();
+    writerThread.wait();
+    writer = nullptr;
+}
+
+/**
+ * @brief DataBase::beginTurn
+ * Начинает ход: все записи до commitTurn собираются в один пакет и пишутся одной транзакцией.
+ * Повторный вызов при начатом ходе ничего не делает
+ */
+void DataBase::beginTurn() {
+    inTurn = true;
+}
+
+/**
+ * @brief DataBase::commitTurn
+ * Заканчивает ход: передает пакет писателю и просит его записать пакет, не дожидаясь таймера
+ */
+void DataBase::commitTurn() {
+    TRACE_SPAN("DataBase::commitTurn");
+    if (!inTurn)
+        return;
+    inTurn = false;
+    submitPending();
+    if (writer)
+        QMetaObject::invokeMethod(writer, "flush", Qt::QueuedConnection);
+}
+
+/**
+ * @brief DataBase::flushAndWait
+ * Синхронно дописывает очередь писателя. Используется только при чтении и при выходе
+ */
+void DataBase::flushAndWait() {
+    if (!writer)
+        return;
+    submitPending();
+    while (pendingBatch || writeQueue.size() > 0) {
+        QMetaObject::invokeMethod(writer, "flush", Qt::BlockingQueuedConnection);
+        submitPending();
+    }
+}
+
+int DataBase::queueDepth() const {
+    return m_queueDepth;
+}
+
+qint64 DataBase::flushLatency() const {
+    return m_flushLatency;
+}
+
+void DataBase::onFlushed(int ops, qint64 latencyUs) {
+    m_queueDepth -= ops;
+    m_flushLatency = latencyUs;
+    emit statsChanged();
+}
+
+/**
+ * @brief DataBase::enqueue
+ * Добавляет операцию в пакет текущего хода. Повторные изменения одной ячейки, счета
+ * и состояния генератора внутри пакета схлопываются до последнего значения.
+ * Вне хода пакет сразу передается писателю
+ */
+void DataBase::enqueue(PersistenceOp::Type type, int id, qint64 first, qint64 second,
+                       const QByteArray& payload) {
+    if (!pendingBatch)
+        pendingBatch = new PersistenceBatch();
+    switch (type) {
+    case PersistenceOp::UpdatePosition: {
+        auto it = pendingCells.find(id);
+        if (it == pendingCells.end())
+            it = pendingCells.insert(id, -1);
+        coalesce(it.value(), type, id, first, second);
+        break;
+    }
+    case PersistenceOp::UpdateScore:
+        coalesce(pendingScore, type, id, first, second);
+        break;
+    case PersistenceOp::UpdateRandomState:
+        coalesce(pendingRandomState, type, id, first, second);
+        break;
+    case PersistenceOp::UpdateGeometry:
+        coalesce(pendingGeometry, type, id, first, second);
+        break;
+    case PersistenceOp::AppendJournal:
+        pendingBatch->append({type, id, first, second, payload});
+        break;
+    default:
+        // операции, меняющие состав строк, нельзя переставлять с обновлениями
+        pendingCells.clear();
+        pendingScore = -1;
+        pendingRandomState = -1;
+        pendingGeometry = -1;
+        pendingBatch->append({type, id, first, second, payload});
+        break;
+    }
+    if (!inTurn)
+        submitPending();
+}
+
+void DataBase::coalesce(int& pendingIndex, PersistenceOp::Type type, int id, qint64 first, qint64 second) {
+    if (pendingIndex >= 0) {
+        PersistenceOp& op = (*pendingBatch)[pendingIndex];
+        op.first = first;
+        op.second = second;
+        return;
+    }
+    pendingIndex = pendingBatch->size();
+    pendingBatch->append({type, id, first, second});
+}
+
+/**
+ * @brief DataBase::submitPending
+ * Передает накопленный пакет писателю. Если очередь заполнена,
+ * пакет остается накапливаться до следующей попытки
+ */
+void DataBase::submitPending() {
+    if (!pendingBatch || !writer)
+        return;
+    int ops = pendingBatch->size();
+    if (!writeQueue.push(pendingBatch))
+        return;
+    pendingBatch = nullptr;
+    pendingCells.clear();
+    pendingScore = -1;
+    pendingRandomState = -1;
+    pendingGeometry = -1;
+    m_queueDepth += ops;
+    emit statsChanged();
+}
+
+/**
+ * @brief DataBase::loadLastPositions
+ * Передает сохраненные ячейки получателю в порядке их номеров
+ * * @param visitor - получатель ячеек
+ * * @return количество сохраненных ячеек
+ */
+int DataBase::loadLastPositions(const CellVisitor& visitor) {
+    TRACE_SPAN("DataBase::loadLastPositions");
+    return openReader()->loadPositions(visitor);
+}
+
+/**
+ * @brief DataBase::loadLastInformation
+ * * @param info - заполняется сохраненной информацией о партии
+ * * @return true, если информация сохранена
+ */
+bool DataBase::loadLastInformation(SavedInformation& info) {
+    TRACE_SPAN("DataBase::loadLastInformation");
+    return openReader()->loadInformation(info);
+}
+
+/**
+ * @brief DataBase::getLastProgressPosition
+ * Текстовое представление сохраненных ячеек для диагностики
+ */
+QJsonArray DataBase::getLastProgressPosition() {
+    return openReader()->readPositions();
+}
+
+QJsonArray DataBase::getLastInformation() {
+    return openReader()->readInformation();
+}
+
+void DataBase::insertNewPosition(int id, const Cell cell) {
+    enqueue(PersistenceOp::InsertPosition, id, cell.getNumColor(), cell.isBusy);
+}
+
+void DataBase::insertNewBasicInfo(int id, quint64 seed) {
+    enqueue(PersistenceOp::InsertInfo, id, qint64(seed));
+}
+
+void DataBase::updateStatusPosition(int id, const Cell cell) {
+    enqueue(PersistenceOp::UpdatePosition, id, cell.getNumColor(), cell.isBusy);
+}
+
+void DataBase::updateScore(int id, int score) {
+    enqueue(PersistenceOp::UpdateScore, id, score);
+}
+
+void DataBase::updateRandomState(int id, quint64 state) {
+    enqueue(PersistenceOp::UpdateRandomState, id, qint64(state));
+}
+
+void DataBase::updateGeometry(int id, int rows, int columns) {
+    enqueue(PersistenceOp::UpdateGeometry, id, rows, columns);
+}
+
+void DataBase::clearTablePositions() {
+    enqueue(PersistenceOp::ClearPositions, 0);
+}
+
+void DataBase::clearTableInformation() {
+    enqueue(PersistenceOp::ClearInformation, 0);
+}
+
+/**
+ * @brief DataBase::saveSlot
+ * Копирует текущую партию в слот сохранения. Копия делается писателем после
+ * всех уже переданных ему изменений, поэтому совпадает с партией на момент вызова
+ * * @param slot - номер слота, 1..SLOT_COUNT
+ */
+void DataBase::saveSlot(int slot) {
+    enqueue(PersistenceOp::SaveSlot, slot, QDateTime::currentSecsSinceEpoch());
+}
+
+void DataBase::deleteSlot(int slot) {
+    enqueue(PersistenceOp::DeleteSlot, slot);
+}
+
+/**
+ * @brief DataBase::recordScore
+ * Передает писателю результат законченной партии для таблицы рекордов
+ */
+void DataBase::recordScore(const ScoreRecord& record) {
+    enqueue(PersistenceOp::RecordScore, 0, 0, 0, record.toBytes());
+}
+
+/**
+ * @brief DataBase::listSaveSlots
+ * Читает только заголовки слотов сохранения, без ячеек
+ * * @return по объекту на слот: slot, isUsed, score, rows, columns, savedAt
+ */
+QVariantList DataBase::listSaveSlots() {
+    TRACE_SPAN("DataBase::listSaveSlots");
+    QVariantList list;
+    StorageBackend* storage = openReader();
+    for (int slot = 1; slot <= StorageBackend::SLOT_COUNT; ++slot) {
+        SavedInformation info;
+        bool isUsed = storage->loadInformation(info, slot);
+        QVariantMap item;
+        item.insert("slot", slot);
+        item.insert("isUsed", isUsed);
+        item.insert("score", info.score);
+        item.insert("rows", info.rows);
+        item.insert("columns", info.columns);
+        item.insert("savedAt", isUsed ? QDateTime::fromSecsSinceEpoch(info.savedAt).toString("yyyy-MM-dd hh:mm")
+                                      : QString());
+        list.append(item);
+    }
+    return list;
+}
+
+/**
+ * @brief DataBase::appendJournal
+ * Дописывает события журнала ходов в пакет текущего хода
+ * * @param gameStart - смещение начала новой партии в bytes, либо -1
+ */
+void DataBase::appendJournal(const QByteArray& bytes, qint64 gameStart) {
+    enqueue(PersistenceOp::AppendJournal, 0, gameStart, 0, bytes);
+}
+
+/**
+ * @brief DataBase::readJournal
+ * Читает журнал ходов начиная с последней партии одним последовательным чтением
+ * * @return хвост журнала, либо пустой массив, если журнала нет
+ */
+QByteArray DataBase::readJournal() {
+    TRACE_SPAN("DataBase::readJournal");
+    flushAndWait();
+    return JournalIndex::readLastGame(NAME_JOURNAL);
+}
@@ -0,0 +1,114 @@
+#ifndef DATABASE_H
+#define DATABASE_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QDebug>
+#include <QHash>
+#include <QThread>
+#include <QVariantList>
+
+#include "structs.h"
+#include "persistenceworker.h"
+#include "scoretable.h"
+
+#define VERSION_BASE    "4"
+#define NAME_BASE       "ColorLinesDB"VERSION_BASE".db"
+#define NAME_SNAPSHOT   "ColorLinesSnapshot"VERSION_BASE".bin"
+#define NAME_JOURNAL    "ColorLinesJournal"VERSION_BASE".bin"
+#define NAME_QUICKSTART "ColorLinesQuickStart"VERSION_BASE".bin"
+#define NAME_SCORES     "ColorLinesScores"VERSION_BASE".db"
+
+#define READER_CONNECTION "ColorLinesReader"
+
+/**
+ * Хранилище последней партии, слотов сохранения и таблицы рекордов.
+ * Чтение выполняется в потоке интерфейса, а запись - фоновым писателем:
+ * изменения хода накапливаются и схлопываются в пакет, который передается писателю
+ * через очередь без блокировок, поэтому ход никогда не ждет диска.
+ * Соединение чтения открывается при первом чтении, чтобы не задерживать запуск.
+ * Формат хранения (SQLite или двоичный снимок) выбирается до connectToDB
+ */
+class DataBase : public QObject
+{
+    Q_OBJECT
+public:
+    Q_PROPERTY(int    queueDepth   READ queueDepth   NOTIFY statsChanged)
+    Q_PROPERTY(qint64 flushLatency READ flushLatency NOTIFY statsChanged)
+
+    DataBase(QObject *parent = 0);
+    ~DataBase();
+
+    void        setStorageType(StorageType type);
+    StorageType getStorageType() const;
+    void        connectToDB();
+
+    StorageBackend* openReader();
+
+    int  loadLastPositions(const CellVisitor& visitor);
+    bool loadLastInformation(SavedInformation& info);
+
+    QJsonArray getLastProgressPosition();
+    QJsonArray getLastInformation();
+
+    void insertNewPosition(int id, const Cell cell);
+    void insertNewBasicInfo(int id, quint64 seed);
+    void updateStatusPosition(int id, const Cell cell);
+    void updateScore(int id, int score);
+    void updateRandomState(int id, quint64 state);
+    void updateGeometry(int id, int rows, int columns);
+    void clearTablePositions();
+    void clearTableInformation();
+
+    void saveSlot(int slot);
+    Q_INVOKABLE void deleteSlot(int slot);
+    void recordScore(const ScoreRecord& record);
+
+    Q_INVOKABLE QVariantList listSaveSlots();
+
+    void       appendJournal(const QByteArray& bytes, qint64 gameStart = -1);
+    QByteArray readJournal();
+
+    void beginTurn();
+    void commitTurn();
+    void flushAndWait();
+
+    int    queueDepth() const;
+    qint64 flushLatency() const;
+
+signals:
+    void statsChanged();
+
+private slots:
+    void onFlushed(int ops, qint64 latencyUs);
+
+private:
+    StorageType     storageType {StorageType::SQLITE};
+    StorageBackend* reader = nullptr;
+    bool            inTurn {false};
+
+    QThread            writerThread;
+    PersistenceWorker* writer = nullptr;
+    PersistenceQueue   writeQueue;
+
+    PersistenceBatch*  pendingBatch = nullptr;
+    QHash<int, int>    pendingCells;
+    int                pendingScore       = -1;
+    int                pendingRandomState = -1;
+    int                pendingGeometry    = -1;
+
+    int    m_queueDepth   {0};
+    qint64 m_flushLatency {0};
+
+    void startWriter();
+    void stopWriter();
+    void enqueue(PersistenceOp::Type type, int id, qint64 first = 0, qint64 second = 0,
+                 const QByteArray& payload = QByteArray());
+    void coalesce(int& pendingIndex, PersistenceOp::Type type, int id, qint64 first, qint64 second);
+    void submitPending();
+};
+
+#endif // DATABASE_H
@@ -0,0 +1,911 @@
+#include "gameboard.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QRandomGenerator>
+
+#include "snapshotstorage.h"
+#include "startupmetrics.h"
+#include "tracer.h"
+
+GameBoard::~GameBoard(){
+    hintWorker->cancel();
+    hintThread.quit();
+    hintThread.wait();
+    turnWorker->cancel();
+    turnThread.quit();
+    turnThread.wait();
+    startupThread.quit();
+    startupThread.wait();
+}
+
+GameBoard::GameBoard(const LinesRules& rules, int rows, int columns, QObject *parent)
+    : QAbstractListModel (parent),
+      rules(rules) {
+    roles[cellColor]  = "cellColor";
+    roles[cellIsBusy] = "cellIsBusy";
+    std::unique_ptr<LinesEngine> created = LinesEngine::create(rows, columns, rules);
+    if (!created) {
+        qDebug() << "ERROR in GameBoard: unsupported board size" << rows << "x" << columns;
+        created = LinesEngine::create(LinesEngine::DEFAULT_ROWS, LinesEngine::DEFAULT_COLUMNS, rules);
+    }
+    replaceEngine(std::move(created));
+    startRows = engine->rows();
+    startColumns = engine->columns();
+
+    hintWorker = new HintWorker();
+    hintWorker->moveToThread(&hintThread);
+    connect(&hintThread, &QThread::finished, hintWorker, &QObject::deleteLater);
+    connect(hintWorker, &HintWorker::found, this, &GameBoard::hintFound);
+    hintThread.start();
+
+    turnWorker = new TurnWorker();
+    turnWorker->moveToThread(&turnThread);
+    connect(&turnThread, &QThread::finished, turnWorker, &QObject::deleteLater);
+    connect(turnWorker, &TurnWorker::resolved, this, &GameBoard::turnResolved);
+    turnThread.start();
+}
+
+/**
+ * @brief GameBoard::data
+ * Отдает готовые значения палитры, не собирая Cell и строки цвета
+ */
+QVariant GameBoard::data(const QModelIndex &index, int role) const{
+    if (!index.isValid())
+        return QVariant();
+    switch (role){
+    case cellColor:
+        return Palette::colorValue(engine->colorAt(index.row()));
+    case cellIsBusy:
+        return Palette::busyValue(engine->isBusy(index.row()));
+    }
+    return QVariant();
+}
+
+int GameBoard::rowCount(const QModelIndex &parent) const{
+    Q_UNUSED(parent);
+    return engine->cells();
+}
+
+QHash<int, QByteArray> GameBoard::roleNames() const{
+    return roles;
+}
+
+void GameBoard::clearBoard() {
+    cancelHint();
+    cancelTurn();
+    isScoreRecorded = false;
+    history.clear();
+    emit historyChanged();
+    appDb->beginTurn();
+    beginChanges();
+    engine->reset();
+    markAllDirty();
+    makeComputerMove();
+    endChanges();
+    journal.recordSnapshot(*engine);
+    saveJournal();
+    appDb->commitTurn();
+}
+
+/**
+ * @brief GameBoard::refresh
+ * Синхронно восстанавливает последнюю партию: сначала из журнала ходов, затем из хранилища,
+ * а если сохранения нет - начинает новую
+ */
+void GameBoard::refresh() {
+    TRACE_SPAN("GameBoard::refresh");
+    applyRestored(GameRestorer::restore(appDb->readJournal(), *appDb->openReader(), rules));
+}
+
+/**
+ * @brief GameBoard::showQuickStart
+ * Показывает партию из быстрого снимка, записанного при прошлом выходе.
+ * Снимок только для показа: партия из журнала и хранилища заменит его в finishRestore
+ * * @return true - если снимок есть и показан
+ */
+bool GameBoard::showQuickStart() {
+    TRACE_SPAN("GameBoard::showQuickStart");
+    if (!QFile::exists(NAME_QUICKSTART))
+        return false;
+    SnapshotStorage storage(NAME_QUICKSTART);
+    RestoredGame game;
+    if (!storage.open() || !GameRestorer::fromStorage(storage, rules, game))
+        return false;
+    replaceEngine(std::move(game.engine));
+    setIsFinal(engine->isFinal());
+    emit seedChanged(seed());
+    isQuickStartShown = true;
+    return true;
+}
+
+/**
+ * @brief GameBoard::beginRestore
+ * Запускает восстановление последней партии в фоновом потоке.
+ * Пока партия не применена, ходы игрока и подсказки не принимаются
+ */
+void GameBoard::beginRestore() {
+    if (startupLoader)
+        return;
+    m_isRestoring = true;
+    isRestoreLoaded = false;
+    emit restoringChanged();
+    startupLoader = new StartupLoader(appDb->getStorageType(), NAME_JOURNAL, rules);
+    startupLoader->moveToThread(&startupThread);
+    connect(&startupThread, &QThread::started, startupLoader, &StartupLoader::load);
+    connect(&startupThread, &QThread::finished, startupLoader, &QObject::deleteLater);
+    connect(startupLoader, &StartupLoader::loaded, this, &GameBoard::restoreLoaded);
+    startupThread.start();
+}
+
+void GameBoard::restoreLoaded() {
+    StartupMetrics::mark("restore loaded");
+    isRestoreLoaded = true;
+    finishRestore();
+}
+
+/**
+ * @brief GameBoard::firstFrameShown
+ * Отмечает, что первый кадр показан: теперь восстановленную партию можно применять,
+ * не задерживая появление окна. Следующие кадры окна больше не отслеживаются
+ */
+void GameBoard::firstFrameShown() {
+    if (sender())
+        disconnect(sender(), nullptr, this, nullptr);
+    if (isFrameShown)
+        return;
+    isFrameShown = true;
+    StartupMetrics::mark("first frame");
+    finishRestore();
+}
+
+/**
+ * @brief GameBoard::finishRestore
+ * Применяет восстановленную партию, когда она загружена и первый кадр показан.
+ * Показанный быстрый снимок сверяется с ней: отличающиеся ячейки обновит обычная сверка модели
+ */
+void GameBoard::finishRestore() {
+    if (!m_isRestoring || !isRestoreLoaded || !isFrameShown)
+        return;
+    TRACE_SPAN("GameBoard::finishRestore");
+    RestoredGame game = startupLoader->takeResult();
+    startupThread.quit();
+    startupThread.wait();
+    startupLoader = nullptr;
+
+    if (isQuickStartShown) {
+        const LinesEngine* saved = game.engine.get();
+        bool isSame = saved && saved->rows() == engine->rows() && saved->columns() == engine->columns() &&
+                saved->score() == engine->score() && saved->seed() == engine->seed() &&
+                saved->randomState() == engine->randomState();
+        for (int i = 0; isSame && i < engine->cells(); ++i)
+            isSame = saved->isBusy(i) == engine->isBusy(i) && saved->colorAt(i) == engine->colorAt(i);
+        if (!isSame)
+            qDebug() << "startup: quick start snapshot is stale, corrected from the saved game";
+        isQuickStartShown = false;
+    }
+    applyRestored(std::move(game));
+    m_isRestoring = false;
+    emit restoringChanged();
+    StartupMetrics::mark("restore applied");
+    emit restored();
+}
+
+/**
+ * @brief GameBoard::applyRestored
+ * Переносит восстановленную партию на поле одним сбросом или сверкой модели.
+ * Партия из журнала перезаписывает хранилище, так как оно могло отстать от журнала,
+ * а партия из хранилища начинает журнал заново
+ */
+void GameBoard::applyRestored(RestoredGame game) {
+    switch (game.source) {
+    case RestoredGame::JOURNAL:
+        replaceEngine(std::move(game.engine));
+        history = std::move(game.history);
+        emit historyChanged();
+        journal.setMoveCount(game.moves);
+        saveWholeGame();
+        break;
+    case RestoredGame::STORAGE:
+        replaceEngine(std::move(game.engine));
+        history.clear();
+        emit historyChanged();
+        // журнала нет или он поврежден: начинаем его заново со снимка восстановленной партии
+        journal.beginGame(*engine);
+        saveJournal();
+        break;
+    case RestoredGame::NONE:
+        // быстрый снимок мог показать поле другого размера
+        setGeometry(startRows, startColumns);
+        newGame();
+        return;
+    }
+    // законченная партия попала в таблицу рекордов до выхода
+    isScoreRecorded = engine->isFinal();
+    setIsFinal(engine->isFinal());
+    emit seedChanged(seed());
+}
+
+/**
+ * @brief GameBoard::saveQuickStart
+ * Записывает текущую партию в быстрый снимок, который будет показан при следующем запуске
+ * до окончания восстановления. Вызывается при выходе
+ */
+void GameBoard::saveQuickStart() {
+    if (m_isRestoring)
+        return;
+    TRACE_SPAN("GameBoard::saveQuickStart");
+    SnapshotStorage storage(NAME_QUICKSTART);
+    if (!storage.open())
+        return;
+    storage.beginBatch();
+    storage.apply({PersistenceOp::ClearPositions, 0, 0, 0, QByteArray()});
+    storage.apply({PersistenceOp::InsertInfo, 0, qint64(engine->seed()), 0, QByteArray()});
+    storage.apply({PersistenceOp::UpdateGeometry, 0, engine->rows(), engine->columns(), QByteArray()});
+    storage.apply({PersistenceOp::UpdateScore, 0, engine->score(), 0, QByteArray()});
+    storage.apply({PersistenceOp::UpdateRandomState, 0, qint64(engine->randomState()), 0, QByteArray()});
+    for (int i = 0; i < engine->cells(); ++i) {
+        Cell cell = cellAt(i);
+        storage.apply({PersistenceOp::InsertPosition, i, cell.getNumColor(), cell.isBusy, QByteArray()});
+    }
+    storage.commitBatch();
+}
+
+/**
+ * @brief GameBoard::newGame
+ * Начинает новую партию с новым зерном генератора.
+ * Зерно сохраняется, чтобы партию можно было воспроизвести по нему и ходам игрока.
+ * Все записи новой партии выполняются одной транзакцией.
+ * Заменяется только текущая партия: слоты сохранения и таблица рекордов остаются
+ */
+void GameBoard::newGame() {
+    TRACE_SPAN("GameBoard::newGame");
+    quint64 newSeed = QRandomGenerator::global()->generate64();
+    cancelHint();
+    cancelTurn();
+    isScoreRecorded = false;
+    history.clear();
+    emit historyChanged();
+    appDb->beginTurn();
+    beginChanges();
+    appDb->clearTableInformation();
+    appDb->clearTablePositions();
+    appDb->insertNewBasicInfo(0, newSeed);
+    appDb->updateGeometry(0, engine->rows(), engine->columns());
+    fillBoardEmptyCells();
+    setCurrentScore(0);
+    setIsFinal(false);
+    engine->restoreRandom(newSeed, newSeed);
+    emit seedChanged(seed());
+    makeComputerMove();
+    endChanges();
+    journal.beginGame(*engine);
+    saveJournal();
+    appDb->commitTurn();
+}
+
+/**
+ * @brief GameBoard::resize
+ * Начинает новую партию на поле rows x columns
+ */
+void GameBoard::resize(int rows, int columns) {
+    if (!setGeometry(rows, columns))
+        return;
+    newGame();
+}
+
+void GameBoard::fillBoardEmptyCells() {
+    beginChanges();
+    engine->reset();
+    markAllDirty();
+    for (int i = 0; i < engine->cells(); ++i) {
+        appDb->insertNewPosition(i, cellAt(i));
+    }
+    endChanges();
+}
+
+int GameBoard::rows() const {
+    return engine->rows();
+}
+
+int GameBoard::columns() const {
+    return engine->columns();
+}
+
+int GameBoard::hintFrom() const {
+    return m_hintFrom;
+}
+
+int GameBoard::hintTo() const {
+    return m_hintTo;
+}
+
+bool GameBoard::hintBusy() const {
+    return m_hintBusy;
+}
+
+bool GameBoard::isRestoring() const {
+    return m_isRestoring;
+}
+
+bool GameBoard::canUndo() const {
+    return history.canUndo();
+}
+
+bool GameBoard::canRedo() const {
+    return history.canRedo();
+}
+
+bool GameBoard::turnBusy() const {
+    return m_turnBusy;
+}
+
+/**
+ * @brief GameBoard::undo
+ * Отменяет последний ход игрока вместе с ответом компьютера.
+ * Меняются только ячейки хода, они же сохраняются; в журнал пишется отмена и снимок поля
+ * * @return true - если ход отменен
+ */
+bool GameBoard::undo() {
+    TRACE_SPAN("GameBoard::undo");
+    if (m_isRestoring || !history.canUndo())
+        return false;
+    cancelHint();
+    cancelTurn();
+    firstClickCellId = -1;
+    appDb->beginTurn();
+    beginChanges();
+    history.undo(*engine);
+    endChanges();
+    appDb->updateRandomState(0, engine->randomState());
+    setIsFinal(engine->isFinal());
+    journal.recordUndo(*engine);
+    saveJournal();
+    appDb->commitTurn();
+    emit historyChanged();
+    return true;
+}
+
+/**
+ * @brief GameBoard::redo
+ * Повторяет отмененный ход
+ * * @return true - если ход повторен
+ */
+bool GameBoard::redo() {
+    TRACE_SPAN("GameBoard::redo");
+    if (m_isRestoring || !history.canRedo())
+        return false;
+    cancelHint();
+    cancelTurn();
+    firstClickCellId = -1;
+    appDb->beginTurn();
+    beginChanges();
+    history.redo(*engine);
+    endChanges();
+    appDb->updateRandomState(0, engine->randomState());
+    setIsFinal(engine->isFinal());
+    journal.recordRedo(*engine);
+    saveJournal();
+    recordFinishedGame();
+    appDb->commitTurn();
+    emit historyChanged();
+    return true;
+}
+
+/**
+ * @brief GameBoard::saveToSlot
+ * Сохраняет текущую партию в слот. Копию делает писатель, ход при этом не ждет диска
+ * * @param slot - номер слота, 1..SLOT_COUNT
+ * * @return true - если сохранение передано писателю
+ */
+bool GameBoard::saveToSlot(int slot) {
+    if (m_isRestoring || slot <= StorageBackend::LIVE_SLOT || slot > StorageBackend::SLOT_COUNT)
+        return false;
+    appDb->saveSlot(slot);
+    return true;
+}
+
+/**
+ * @brief GameBoard::loadFromSlot
+ * Продолжает партию из слота: она становится текущей, перезаписывает последнюю партию
+ * и начинает журнал ходов заново. История отмены не переносится
+ * * @param slot - номер слота, 1..SLOT_COUNT
+ * * @return true - если слот есть и партия загружена
+ */
+bool GameBoard::loadFromSlot(int slot) {
+    TRACE_SPAN("GameBoard::loadFromSlot");
+    if (m_isRestoring || slot <= StorageBackend::LIVE_SLOT || slot > StorageBackend::SLOT_COUNT)
+        return false;
+    RestoredGame game;
+    if (!GameRestorer::fromStorage(*appDb->openReader(), rules, game, slot))
+        return false;
+    firstClickCellId = -1;
+    replaceEngine(std::move(game.engine));
+    history.clear();
+    emit historyChanged();
+    saveWholeGame();
+    journal.beginGame(*engine);
+    saveJournal();
+    isScoreRecorded = engine->isFinal();
+    setIsFinal(engine->isFinal());
+    emit seedChanged(seed());
+    return true;
+}
+
+/**
+ * @brief GameBoard::requestHint
+ * Запускает поиск лучшего хода в фоне, ответ придет в hintFound
+ */
+void GameBoard::requestHint() {
+    startHint(false);
+}
+
+/**
+ * @brief GameBoard::requestAnalysis
+ * Запускает глубокий анализ на несколько ходов вперед, ответ придет в hintFound
+ */
+void GameBoard::requestAnalysis() {
+    startHint(true);
+}
+
+/**
+ * @brief GameBoard::setAnalysisMemory
+ * Задает объем таблицы транспозиций анализа в мегабайтах
+ */
+void GameBoard::setAnalysisMemory(int megabytes) {
+    QMetaObject::invokeMethod(hintWorker, "resizeTable", Qt::QueuedConnection, Q_ARG(int, megabytes));
+}
+
+void GameBoard::startHint(bool isDeep) {
+    if (engine->isFinal() || m_isRestoring)
+        return;
+    m_hintFrom = -1;
+    m_hintTo = -1;
+    m_hintBusy = true;
+    hintWorker->post(engine->clone(), ++hintRequest, isDeep);
+    emit hintChanged();
+}
+
+/**
+ * @brief GameBoard::cancelHint
+ * Прерывает поиск и убирает показанную подсказку
+ */
+void GameBoard::cancelHint() {
+    if (!hintWorker || (!m_hintBusy && m_hintFrom < 0))
+        return;
+    ++hintRequest;
+    hintWorker->cancel();
+    m_hintFrom = -1;
+    m_hintTo = -1;
+    m_hintBusy = false;
+    emit hintChanged();
+}
+
+/**
+ * @brief GameBoard::hintFound
+ * Показывает найденный ход, если за время поиска не было нового запроса или хода
+ */
+void GameBoard::hintFound(int request, int from, int to) {
+    if (request != hintRequest)
+        return;
+    m_hintFrom = from;
+    m_hintTo = to;
+    m_hintBusy = false;
+    emit hintChanged();
+}
+
+int GameBoard::currentScore() const {
+    return engine->score();
+}
+
+bool GameBoard::isFinal() const {
+    return m_isFinal;
+}
+
+QString GameBoard::seed() const {
+    return QString::number(engine->seed());
+}
+
+void GameBoard::setCurrentScore(int newScore) {
+    engine->setScore(newScore);
+}
+
+void GameBoard::setIsFinal(bool newIsFinal) {
+    if (m_isFinal == newIsFinal)
+        return;
+
+    m_isFinal = newIsFinal;
+    emit isFinalChanged(m_isFinal);
+}
+
+/**
+ * @brief GameBoard::tryToMakeAFirstMove
+ * Проверяет на доступность ячейку, откуда игрок хочет переместить круг и запоминает ее,
+ * в случае ее доступности
+ * * @param index - индекс ячейки, откуда игрок хочет переместить круг
+ * * @return true - если ячейка доступна и запомнена
+ */
+bool GameBoard::tryToMakeAFirstMove(int index) {
+    TRACE_SPAN("GameBoard::tryToMakeAFirstMove");
+    if (m_isRestoring || m_turnBusy)
+        return false;
+    if (firstClickCellId == -1 && !checkCellIsFree(index)) {
+        firstClickCellId = index;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief GameBoard::tryToMakeASecondMove
+ * Передает ход в поток ходов: поиск пути, перемещение, сбор линий и ход компьютера
+ * разыгрываются на копии движка. Итог придет в turnResolved, до тех пор ход занят.
+ * Первый ход сбрасывается в любом случае
+ * * @param index - индекс ячейки, куда хочет сходить игрок
+ * * @return true - если ход передан на розыгрыш
+ */
+bool GameBoard::tryToMakeASecondMove(int index) {
+    TRACE_SPAN("GameBoard::tryToMakeASecondMove");
+    if (firstClickCellId == -1 || m_turnBusy)
+        return false;
+    Move move;
+    move.from = firstClickCellId;
+    move.to = index;
+    firstClickCellId = -1;
+    if (index < 0 || index >= engine->cells() || !checkCellIsFree(index))
+        return false;
+    turnWorker->post(engine->clone(), move, ++turnRequest);
+    setTurnBusy(true);
+    return true;
+}
+
+/**
+ * @brief GameBoard::turnResolved
+ * Принимает итог хода, если за время розыгрыша партия не менялась. Сразу применяется
+ * только перемещение фигуры и открывается транзакция хода; сбор линий и ход компьютера
+ * применит endASecondMove после анимации. Путь отдается lastMovePath
+ */
+void GameBoard::turnResolved(int request) {
+    TurnResult result;
+    if (request != turnRequest || !turnWorker->takeResult(request, result))
+        return;
+    TRACE_SPAN("GameBoard::turnResolved");
+    if (result.path.empty()) {
+        setTurnBusy(false);
+        emit moveResolved(false);
+        return;
+    }
+    cancelHint();
+    appDb->beginTurn();
+    pendingMove = result.move;
+    movePath = std::move(result.path);
+    pendingDelta = std::move(result.delta);
+    isMovePending = true;
+    history.beginTurn(*engine);
+    beginChanges();
+    history.applyChanges(*engine, pendingDelta, 0, pendingDelta.moveChanges);
+    endChanges();
+    emit moveResolved(true);
+}
+
+/**
+ * @brief GameBoard::cancelTurn
+ * Отбрасывает ход, который еще разыгрывается или ждет конца анимации.
+ * Вызывается перед любой заменой партии, поэтому устаревший итог не применяется.
+ * Если перемещение фигуры уже применено, оно обращается, а транзакция хода закрывается
+ */
+void GameBoard::cancelTurn() {
+    if (!turnWorker || !m_turnBusy)
+        return;
+    ++turnRequest;
+    turnWorker->cancel();
+    if (isMovePending) {
+        isMovePending = false;
+        beginChanges();
+        history.abortTurn(*engine);
+        endChanges();
+        appDb->commitTurn();
+    }
+    setTurnBusy(false);
+}
+
+void GameBoard::setTurnBusy(bool isBusy) {
+    if (m_turnBusy == isBusy)
+        return;
+    m_turnBusy = isBusy;
+    emit turnBusyChanged();
+}
+
+/**
+ * @brief GameBoard::lastMovePath
+ * * @return ячейки пути последнего хода игрока от исходной до целевой включительно
+ */
+QVector<int> GameBoard::lastMovePath() const {
+    QVector<int> path;
+    path.reserve(int(movePath.size()));
+    for (int index : movePath)
+        path.append(index);
+    return path;
+}
+
+/**
+ * @brief GameBoard::endASecondMove
+ * Заканчивает ход игрока: применяет разыгранные сбор линий и ход компьютера
+ * и фиксирует транзакцию хода. Представление уведомляется один раз за весь ответ.
+ * Если ход отменили новой партией, ничего не делает
+ */
+void GameBoard::endASecondMove() {
+    if (!isMovePending)
+        return;
+    TRACE_SPAN("GameBoard::endASecondMove");
+    isMovePending = false;
+    beginChanges();
+    history.applyChanges(*engine, pendingDelta, pendingDelta.moveChanges, pendingDelta.changes.size());
+    engine->setScore(pendingDelta.scoreAfter);
+    engine->restoreRandom(engine->seed(), pendingDelta.randomAfter);
+    engine->setSpawned(pendingDelta.spawned);
+    appDb->updateRandomState(0, engine->randomState());
+    setIsFinal(engine->isFinal());
+    endChanges();
+    history.endTurn(*engine);
+    journal.recordTurn(*engine, pendingMove);
+    saveJournal();
+    recordFinishedGame();
+    appDb->commitTurn();
+    setTurnBusy(false);
+    emit historyChanged();
+}
+
+/**
+ * @brief GameBoard::checkCellIsFree
+ * Проверяет свободна ли ячейка
+ * * @param index - индекс, по которому расположена ячейка
+ * * @return true - если ячейка свободна
+ */
+bool GameBoard::checkCellIsFree(int index) const {
+    return !engine->isBusy(index);
+}
+
+/**
+ * @brief GameBoard::cellAt
+ * Собирает представление ячейки из ядра поля
+ * * @param index - индекс ячейки
+ * * @return ячейка с цветом и признаком занятости
+ */
+Cell GameBoard::cellAt(int index) const {
+    Cell cell;
+    cell.setColor(engine->colorAt(index));
+    cell.isBusy = engine->isBusy(index);
+    return cell;
+}
+
+/**
+ * @brief GameBoard::makeComputerMove
+ * Выполняет ход компьютера и проверяет окончание игры
+ */
+void GameBoard::makeComputerMove() {
+    engine->makeComputerMove();
+    appDb->updateRandomState(0, engine->randomState());
+    setIsFinal(engine->isFinal());
+}
+
+/**
+ * @brief GameBoard::setGeometry
+ * Переходит на поле rows x columns, если размер отличается от текущего.
+ * Нулевой размер означает поле по умолчанию
+ * * @return false - если размер не поддерживается движком
+ */
+bool GameBoard::setGeometry(int rows, int columns) {
+    if (rows <= 0 || columns <= 0) {
+        // сохранения до появления размера поля
+        rows = LinesEngine::DEFAULT_ROWS;
+        columns = LinesEngine::DEFAULT_COLUMNS;
+    }
+    if (rows == engine->rows() && columns == engine->columns())
+        return true;
+    std::unique_ptr<LinesEngine> created = LinesEngine::create(rows, columns, rules);
+    if (!created) {
+        qDebug() << "ERROR in setGeometry: unsupported board size" << rows << "x" << columns;
+        return false;
+    }
+    replaceEngine(std::move(created));
+    return true;
+}
+
+/**
+ * @brief GameBoard::replaceEngine
+ * Заменяет движок. Модель сбрасывается только при смене размера поля,
+ * иначе изменившиеся ячейки находит обычная сверка
+ */
+void GameBoard::replaceEngine(std::unique_ptr<LinesEngine> newEngine) {
+    cancelHint();
+    cancelTurn();
+    bool isResized = !engine || engine->rows() != newEngine->rows() ||
+            engine->columns() != newEngine->columns();
+    if (!isResized) {
+        beginChanges();
+        engine = std::move(newEngine);
+        engine->setListener(this);
+        markAllDirty();
+        endChanges();
+        emit currentScoreChanged(engine->score());
+        return;
+    }
+    beginResetModel();
+    engine = std::move(newEngine);
+    engine->setListener(this);
+    dirtyCells.fill(false, engine->cells());
+    shownCells.resize(engine->cells());
+    for (int i = 0; i < engine->cells(); ++i)
+        shownCells[i] = cellState(i);
+    dirtyFirst = engine->cells();
+    dirtyLast = -1;
+    endResetModel();
+    emit geometryChanged();
+    emit currentScoreChanged(engine->score());
+}
+
+/**
+ * @brief GameBoard::saveJournal
+ * Передает новые события журнала ходов в пакет текущего хода
+ */
+void GameBoard::saveJournal() {
+    const std::vector<uint8_t>& data = journal.data();
+    if (data.empty())
+        return;
+    appDb->appendJournal(QByteArray(reinterpret_cast<const char*>(data.data()), int(data.size())),
+                         journal.gameStart());
+    journal.clearData();
+}
+
+/**
+ * @brief GameBoard::recordFinishedGame
+ * Заносит законченную партию в таблицу рекордов один раз: отмена последнего хода
+ * и повтор не создают вторую запись
+ */
+void GameBoard::recordFinishedGame() {
+    if (isScoreRecorded || !engine->isFinal())
+        return;
+    isScoreRecorded = true;
+    ScoreRecord record;
+    record.score = engine->score();
+    record.moves = journal.moveCount();
+    record.rows = engine->rows();
+    record.columns = engine->columns();
+    record.seed = engine->seed();
+    record.finishedAt = QDateTime::currentSecsSinceEpoch();
+    appDb->recordScore(record);
+}
+
+/**
+ * @brief GameBoard::saveWholeGame
+ * Перезаписывает в хранилище всю партию одной транзакцией
+ */
+void GameBoard::saveWholeGame() {
+    appDb->beginTurn();
+    appDb->clearTableInformation();
+    appDb->clearTablePositions();
+    appDb->insertNewBasicInfo(0, engine->seed());
+    appDb->updateGeometry(0, engine->rows(), engine->columns());
+    appDb->updateScore(0, engine->score());
+    appDb->updateRandomState(0, engine->randomState());
+    for (int i = 0; i < engine->cells(); ++i)
+        appDb->insertNewPosition(i, cellAt(i));
+    appDb->commitTurn();
+}
+
+/**
+ * @brief GameBoard::cellChanged
+ * Сохраняет измененную движком ячейку и уведомляет представление
+ * * @param index - индекс ячейки
+ */
+void GameBoard::cellChanged(int index) {
+    appDb->updateStatusPosition(index, cellAt(index));
+    dirtyCells.setBit(index);
+    dirtyFirst = qMin(dirtyFirst, index);
+    dirtyLast = qMax(dirtyLast, index);
+    if (changesDepth == 0)
+        emitChanges();
+}
+
+/**
+ * @brief GameBoard::beginChanges
+ * Начинает сбор изменений ячеек: до парного endChanges представление не уведомляется.
+ * Вызовы могут быть вложенными
+ */
+void GameBoard::beginChanges() {
+    ++changesDepth;
+}
+
+/**
+ * @brief GameBoard::endChanges
+ * Заканчивает сбор изменений и уведомляет представление, когда закрыт внешний вызов
+ */
+void GameBoard::endChanges() {
+    if (--changesDepth == 0)
+        emitChanges();
+}
+
+/**
+ * @brief GameBoard::markAllDirty
+ * Помечает все поле для сверки, после изменения ядра без уведомлений
+ */
+void GameBoard::markAllDirty() {
+    dirtyCells.fill(true);
+    dirtyFirst = 0;
+    dirtyLast = engine->cells() - 1;
+}
+
+/**
+ * @brief GameBoard::emitChanges
+ * Сверяет помеченные ячейки с тем, что уже показано, и испускает dataChanged
+ * по одному на каждый непрерывный диапазон действительно изменившихся ячеек
+ * только с изменившимися ролями
+ */
+void GameBoard::emitChanges() {
+    TRACE_SPAN("GameBoard::emitChanges");
+    int first = -1;
+    bool colorChanged = false;
+    bool busyChanged = false;
+    for (int i = dirtyFirst; i <= dirtyLast + 1; ++i) {
+        quint8 diff = 0;
+        if (i <= dirtyLast && dirtyCells.testBit(i)) {
+            quint8 state = cellState(i);
+            diff = state ^ shownCells[i];
+            shownCells[i] = state;
+        }
+        if (diff) {
+            if (first < 0)
+                first = i;
+            colorChanged |= (diff & 0x7) != 0;
+            busyChanged |= (diff & 0x8) != 0;
+            continue;
+        }
+        if (first < 0)
+            continue;
+        QVector<int> changedRoles;
+        if (colorChanged)
+            changedRoles.append(cellColor);
+        if (busyChanged)
+            changedRoles.append(cellIsBusy);
+        emit dataChanged(this->index(first, 0), this->index(i - 1, 0), changedRoles);
+        first = -1;
+        colorChanged = false;
+        busyChanged = false;
+    }
+    // очищается только сверенный диапазон, чтобы мелкие изменения не стоили обхода всего поля
+    if (dirtyFirst <= dirtyLast)
+        dirtyCells.fill(false, dirtyFirst, dirtyLast + 1);
+    dirtyFirst = engine->cells();
+    dirtyLast = -1;
+}
+
+/**
+ * @brief GameBoard::cellState
+ * * @return состояние ячейки для сверки: цвет и бит занятости
+ */
+quint8 GameBoard::cellState(int index) const {
+    return quint8(engine->colorAt(index) | (engine->isBusy(index) ? 0x8 : 0));
+}
+
+/**
+ * @brief GameBoard::scoreChanged
+ * Сохраняет новый счет и уведомляет представление
+ * * @param score - новый счет
+ */
+void GameBoard::scoreChanged(int score) {
+    appDb->updateScore(0, score);
+    emit currentScoreChanged(score);
+}
+
+/**
+ * @brief GameBoard::cellPlaced
+ * Передает размещение фигуры в историю отмены
+ */
+void GameBoard::cellPlaced(int index, int idColor, int freePos) {
+    history.cellPlaced(index, idColor, freePos);
+}
+
+void GameBoard::cellCleared(int index, int idColor) {
+    history.cellCleared(index, idColor);
+}
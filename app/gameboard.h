@@ -0,0 +1,181 @@
+#ifndef GAMEBOARD_H
+#define GAMEBOARD_H
+
+#include <QObject>
+#include <QAbstractListModel>
+#include <QBitArray>
+#include <QThread>
+#include <QVector>
+
+#include <memory>
+
+#include "palette.h"
+#include "structs.h"
+#include "database.h"
+#include "gamerestorer.h"
+#include "hintworker.h"
+#include "linesengine.h"
+#include "movejournal.h"
+#include "startuploader.h"
+#include "turnworker.h"
+#include "undostack.h"
+
+class GameBoard : public QAbstractListModel, private LinesEngineListener {
+    Q_OBJECT
+public:
+    Q_PROPERTY(int     currentScore READ currentScore WRITE setCurrentScore NOTIFY currentScoreChanged)
+    Q_PROPERTY(bool    isFinal      READ isFinal      WRITE setIsFinal      NOTIFY isFinalChanged)
+    Q_PROPERTY(QString seed         READ seed                               NOTIFY seedChanged)
+    Q_PROPERTY(int     rows         READ rows                               NOTIFY geometryChanged)
+    Q_PROPERTY(int     columns      READ columns                            NOTIFY geometryChanged)
+    Q_PROPERTY(int     hintFrom     READ hintFrom                           NOTIFY hintChanged)
+    Q_PROPERTY(int     hintTo       READ hintTo                             NOTIFY hintChanged)
+    Q_PROPERTY(bool    hintBusy     READ hintBusy                           NOTIFY hintChanged)
+    Q_PROPERTY(bool    isRestoring  READ isRestoring                        NOTIFY restoringChanged)
+    Q_PROPERTY(bool    canUndo      READ canUndo                            NOTIFY historyChanged)
+    Q_PROPERTY(bool    canRedo      READ canRedo                            NOTIFY historyChanged)
+    Q_PROPERTY(bool    turnBusy     READ turnBusy                           NOTIFY turnBusyChanged)
+
+    enum circleRoles {
+        cellColor = Qt::UserRole + 1,
+        cellIsBusy
+    };
+
+    explicit GameBoard(const LinesRules& rules = LinesRules(),
+                       int rows = LinesEngine::DEFAULT_ROWS, int columns = LinesEngine::DEFAULT_COLUMNS,
+                       QObject *parent = 0);
+    ~GameBoard();
+    DataBase* appDb = nullptr;
+    virtual QVariant data(const QModelIndex &index, int role) const override;
+    virtual int rowCount(const QModelIndex &parent) const override;
+    virtual QHash<int, QByteArray> roleNames() const override;
+
+    int     currentScore() const;
+    bool    isFinal() const;
+    QString seed() const;
+    int     rows() const;
+    int     columns() const;
+    int     hintFrom() const;
+    int     hintTo() const;
+    bool    hintBusy() const;
+    bool    isRestoring() const;
+    bool    canUndo() const;
+    bool    canRedo() const;
+    bool    turnBusy() const;
+
+    Q_INVOKABLE QVector<int> lastMovePath() const;
+
+public slots:
+    void refresh();
+    bool showQuickStart();
+    void beginRestore();
+    void firstFrameShown();
+    void saveQuickStart();
+    void newGame();
+    void resize(int rows, int columns);
+    void requestHint();
+    void requestAnalysis();
+    void cancelHint();
+    void setAnalysisMemory(int megabytes);
+    bool undo();
+    bool redo();
+    bool saveToSlot(int slot);
+    bool loadFromSlot(int slot);
+    void clearBoard();
+    void fillBoardEmptyCells();
+
+    bool tryToMakeAFirstMove(int index);
+    bool tryToMakeASecondMove(int index);
+    void endASecondMove();
+
+    void setCurrentScore(int newScore);
+    void setIsFinal(bool newIsFinal);
+
+signals:
+    void currentScoreChanged(int currentScore);
+    void isFinalChanged(bool isFinal);
+    void seedChanged(QString seed);
+    void geometryChanged();
+    void hintChanged();
+    void restoringChanged();
+    void historyChanged();
+    void restored();
+    void turnBusyChanged();
+    void moveResolved(bool isMoved);
+
+private slots:
+    void hintFound(int request, int from, int to);
+    void restoreLoaded();
+    void turnResolved(int request);
+
+private:
+    LinesRules                   rules;
+    std::unique_ptr<LinesEngine> engine;
+    MoveJournal                  journal;
+    UndoStack                    history;
+    Move                         pendingMove;
+    std::vector<int>             movePath;
+    QHash<int, QByteArray> roles;
+
+    bool    m_isFinal        {false};
+    bool    isScoreRecorded  {false};
+
+    int firstClickCellId = -1;
+
+    QThread     hintThread;
+    HintWorker* hintWorker  = nullptr;
+    int         hintRequest = 0;
+    int         m_hintFrom  {-1};
+    int         m_hintTo    {-1};
+    bool        m_hintBusy  {false};
+
+    QThread     turnThread;
+    TurnWorker* turnWorker    = nullptr;
+    int         turnRequest   = 0;
+    TurnDelta   pendingDelta;
+    bool        isMovePending {false};
+    bool        m_turnBusy    {false};
+
+    QThread        startupThread;
+    StartupLoader* startupLoader     = nullptr;
+    int            startRows;
+    int            startColumns;
+    bool           m_isRestoring     {false};
+    bool           isRestoreLoaded   {false};
+    bool           isFrameShown      {false};
+    bool           isQuickStartShown {false};
+
+    QBitArray       dirtyCells;
+    QVector<quint8> shownCells;
+    int             dirtyFirst   {0};
+    int             dirtyLast    {-1};
+    int             changesDepth {0};
+
+    bool checkCellIsFree(int index) const;
+    Cell cellAt(int index) const;
+
+    void makeComputerMove();
+    void startHint(bool isDeep);
+    void cancelTurn();
+    void setTurnBusy(bool isBusy);
+    bool setGeometry(int rows, int columns);
+    void replaceEngine(std::unique_ptr<LinesEngine> newEngine);
+    void applyRestored(RestoredGame game);
+    void finishRestore();
+    void saveJournal();
+    void recordFinishedGame();
+
+    void   beginChanges();
+    void   endChanges();
+    void   markAllDirty();
+    void   emitChanges();
+    quint8 cellState(int index) const;
+    void saveWholeGame();
+
+    void cellChanged(int index) override;
+    void scoreChanged(int score) override;
+    void cellPlaced(int index, int idColor, int freePos) override;
+    void cellCleared(int index, int idColor) override;
+};
+
+#endif // GAMEBOARD_H
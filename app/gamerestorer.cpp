@@ -0,0 +1,95 @@
+#include "gamerestorer.h"
+
+#include <QDebug>
+
+#include <climits>
+
+#include "movejournal.h"
+#include "tracer.h"
+
+/**
+ * @brief GameRestorer::fromJournal
+ * Перематывает последнюю партию журнала ходов с начала, заполняя историю отмены
+ * * @param bytes - содержимое журнала
+ * * @param game - заполняется восстановленной партией
+ * * @return true - если партия восстановлена
+ */
+bool GameRestorer::fromJournal(const QByteArray& bytes, const LinesRules& rules, RestoredGame& game) {
+    TRACE_SPAN("GameRestorer::fromJournal");
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.constData());
+    size_t size = size_t(bytes.size());
+    std::vector<size_t> games = MoveJournal::findGames(data, size);
+    if (games.empty())
+        return false;
+    const uint8_t* last = data + games.back();
+    size_t lastSize = size - games.back();
+    uint64_t seed;
+    int rows, columns;
+    if (!MoveJournal::readGame(last, lastSize, seed, rows, columns))
+        return false;
+    std::unique_ptr<LinesEngine> restored = LinesEngine::create(rows, columns, rules);
+    int moves = restored ? MoveJournal::replay(last, lastSize, INT_MAX, *restored, &game.history) : -1;
+    if (moves < 0) {
+        qDebug() << "ERROR in GameRestorer::fromJournal: journal does not match the rules";
+        return false;
+    }
+    game.source = RestoredGame::JOURNAL;
+    game.engine = std::move(restored);
+    game.moves = moves;
+    return true;
+}
+
+/**
+ * @brief GameRestorer::fromStorage
+ * Читает партию из хранилища: размер поля, ячейки, счет и состояние генератора.
+ * Сохранения без размера поля относятся к полю по умолчанию
+ * * @param storage - открытое хранилище
+ * * @param game - заполняется восстановленной партией
+ * * @param slot - номер слота сохранения, LIVE_SLOT - последняя партия
+ * * @return true - если сохранение есть и его размер поддерживается
+ */
+bool GameRestorer::fromStorage(StorageBackend& storage, const LinesRules& rules, RestoredGame& game,
+                               int slot) {
+    TRACE_SPAN("GameRestorer::fromStorage");
+    SavedInformation info;
+    if (!storage.loadInformation(info, slot))
+        return false;
+    if (info.rows <= 0 || info.columns <= 0) {
+        info.rows = LinesEngine::DEFAULT_ROWS;
+        info.columns = LinesEngine::DEFAULT_COLUMNS;
+    }
+    std::unique_ptr<LinesEngine> restored = LinesEngine::create(info.rows, info.columns, rules);
+    if (!restored) {
+        qDebug() << "ERROR in GameRestorer::fromStorage: unsupported board size"
+                 << info.rows << "x" << info.columns;
+        return false;
+    }
+    LinesEngine* target = restored.get();
+    int count = storage.loadPositions([target](int id, int color, bool isBusy) {
+        if (isBusy && id >= 0 && id < target->cells())
+            target->restoreCell(id, color);
+    }, slot);
+    if (count <= 0)
+        return false;
+    // после хода линии сразу снимаются, поэтому стоящая на поле линия - признак порчи сохранения
+    int lines = restored->countLines(rules.lengthWin);
+    if (lines > 0) {
+        qDebug() << "ERROR in GameRestorer::fromStorage: saved board has" << lines << "unremoved lines";
+        return false;
+    }
+    restored->setScore(info.score);
+    restored->restoreRandom(info.seed, info.randomState);
+    game.source = RestoredGame::STORAGE;
+    game.engine = std::move(restored);
+    game.moves = 0;
+    game.history.clear();
+    return true;
+}
+
+RestoredGame GameRestorer::restore(const QByteArray& journal, StorageBackend& storage,
+                                   const LinesRules& rules) {
+    RestoredGame game;
+    if (!fromJournal(journal, rules, game))
+        fromStorage(storage, rules, game);
+    return game;
+}
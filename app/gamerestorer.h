@@ -0,0 +1,46 @@
+#ifndef GAMERESTORER_H
+#define GAMERESTORER_H
+
+#include <QByteArray>
+
+#include <memory>
+
+#include "linesengine.h"
+#include "storagebackend.h"
+#include "undostack.h"
+
+/**
+ * Партия, восстановленная без участия модели: движок и источник, откуда он получен
+ */
+struct RestoredGame {
+    enum Source {
+        NONE,     // сохранения нет, нужна новая партия
+        JOURNAL,  // партия перемотана по журналу ходов
+        STORAGE   // партия прочитана из хранилища
+    };
+
+    Source                       source = NONE;
+    std::unique_ptr<LinesEngine> engine;
+    int                          moves  = 0;  // ходов в журнале, для source == JOURNAL
+    UndoStack                    history;     // история отмены, восстанавливается только из журнала
+};
+
+/**
+ * Восстановление последней партии в отдельном движке.
+ * Не трогает модель и хранилище записи, поэтому может выполняться в любом потоке
+ */
+class GameRestorer {
+public:
+    static bool fromJournal(const QByteArray& bytes, const LinesRules& rules, RestoredGame& game);
+    static bool fromStorage(StorageBackend& storage, const LinesRules& rules, RestoredGame& game,
+                            int slot = StorageBackend::LIVE_SLOT);
+
+    /**
+     * @brief GameRestorer::restore
+     * Восстанавливает партию сначала из журнала ходов, затем из хранилища
+     * * @return восстановленная партия, либо партия с source == NONE
+     */
+    static RestoredGame restore(const QByteArray& journal, StorageBackend& storage, const LinesRules& rules);
+};
+
+#endif // GAMERESTORER_H
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Проверка отрисовки поля без экрана: ColorLines запускается с графом сцены по умолчанию
+# и с программным рендером, на поле по умолчанию и на наибольшем поле. Каждый запуск
+# должен сохранить кадр через --grab и завершиться без ошибки.
+# Запуски идут во временном каталоге, чтобы не трогать сохраненные партии игрока.
+# Использование: grab-check.sh [путь/к/ColorLines]
+
+app=$(cd "$(dirname "${1:-./ColorLines}")" && pwd)/$(basename "${1:-./ColorLines}")
+work=$(mktemp -d) || exit 1
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 1
+
+fail=0
+for backend in default software; do
+    for size in 9 64; do
+        out="grab-$backend-$size.png"
+        if [ "$backend" = software ]; then
+            QT_QUICK_BACKEND=software QT_QPA_PLATFORM=offscreen \
+                "$app" --rows "$size" --columns "$size" --grab "$out"
+        else
+            QT_QPA_PLATFORM=offscreen "$app" --rows "$size" --columns "$size" --grab "$out"
+        fi
+        status=$?
+        if [ $status -ne 0 ] || [ ! -s "$out" ]; then
+            echo "FAIL: $backend backend, ${size}x$size board (exit code $status)"
+            fail=1
+        else
+            echo "ok: $backend backend, ${size}x$size board"
+        fi
+    done
+done
+exit $fail
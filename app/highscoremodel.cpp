@@ -0,0 +1,87 @@
+#include "highscoremodel.h"
+
+#include <QDateTime>
+
+#include "tracer.h"
+
+HighScoreModel::HighScoreModel(QObject *parent)
+    : QAbstractListModel(parent) {
+}
+
+QVariant HighScoreModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= records.size())
+        return QVariant();
+    const ScoreRecord& record = records[index.row()];
+    switch (role) {
+    case scoreRank:
+        return index.row() + 1;
+    case scoreValue:
+        return record.score;
+    case scoreMoves:
+        return record.moves;
+    case scoreBoard:
+        return QString("%1x%2").arg(record.rows).arg(record.columns);
+    case scoreFinishedAt:
+        return QDateTime::fromSecsSinceEpoch(record.finishedAt).toString("yyyy-MM-dd hh:mm");
+    }
+    return QVariant();
+}
+
+int HighScoreModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid())
+        return 0;
+    return records.size();
+}
+
+QHash<int, QByteArray> HighScoreModel::roleNames() const {
+    QHash<int, QByteArray> roles;
+    roles[scoreRank]       = "rank";
+    roles[scoreValue]      = "score";
+    roles[scoreMoves]      = "moves";
+    roles[scoreBoard]      = "board";
+    roles[scoreFinishedAt] = "finishedAt";
+    return roles;
+}
+
+bool HighScoreModel::canFetchMore(const QModelIndex &parent) const {
+    return !parent.isValid() && !isComplete;
+}
+
+/**
+ * @brief HighScoreModel::fetchMore
+ * Дочитывает следующую страницу от последней показанной записи
+ */
+void HighScoreModel::fetchMore(const QModelIndex &parent) {
+    TRACE_SPAN("HighScoreModel::fetchMore");
+    if (parent.isValid() || isComplete)
+        return;
+    if (!table) {
+        table.reset(new ScoreTable(NAME_SCORES, SCORES_READER_CONNECTION));
+        if (!table->open()) {
+            isComplete = true;
+            return;
+        }
+    }
+    QVector<ScoreRecord> page;
+    const ScoreRecord* after = records.isEmpty() ? nullptr : &records.last();
+    int count = table->loadPage(after, SCORES_PAGE_SIZE, page);
+    isComplete = count < SCORES_PAGE_SIZE;
+    if (count == 0)
+        return;
+    beginInsertRows(QModelIndex(), records.size(), records.size() + count - 1);
+    records += page;
+    endInsertRows();
+}
+
+/**
+ * @brief HighScoreModel::refresh
+ * Дописывает еще не записанные результаты и начинает список заново с лучшей записи
+ */
+void HighScoreModel::refresh() {
+    if (appDb)
+        appDb->flushAndWait();
+    beginResetModel();
+    records.clear();
+    isComplete = false;
+    endResetModel();
+}
@@ -0,0 +1,51 @@
+#ifndef HIGHSCOREMODEL_H
+#define HIGHSCOREMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+
+#include <memory>
+
+#include "database.h"
+#include "scoretable.h"
+
+#define SCORES_READER_CONNECTION "ColorLinesScoresReader"
+#define SCORES_PAGE_SIZE         50
+
+/**
+ * Таблица рекордов для QML. Записи подгружаются страницами по мере прокрутки списка
+ * (canFetchMore/fetchMore), поэтому открытие таблицы читает одну страницу
+ * независимо от числа сохраненных партий.
+ * Соединение чтения открывается при первой странице
+ */
+class HighScoreModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    enum scoreRoles {
+        scoreRank = Qt::UserRole + 1,
+        scoreValue,
+        scoreMoves,
+        scoreBoard,
+        scoreFinishedAt
+    };
+
+    explicit HighScoreModel(QObject *parent = 0);
+    DataBase* appDb = nullptr;
+
+    QVariant data(const QModelIndex &index, int role) const override;
+    int rowCount(const QModelIndex &parent) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+public slots:
+    void refresh();
+
+private:
+    std::unique_ptr<ScoreTable> table;
+    QVector<ScoreRecord>        records;
+    bool                        isComplete {false};
+};
+
+#endif // HIGHSCOREMODEL_H
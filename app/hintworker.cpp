@@ -0,0 +1,101 @@
+#include "hintworker.h"
+
+#include "tracer.h"
+
+HintWorker::HintWorker(QObject *parent)
+    : QObject(parent),
+      hintSearch(pool, heuristic),
+      table(0),
+      analysis(pool, table) {
+}
+
+/**
+ * @brief HintWorker::post
+ * Передает позицию для поиска, прерывая текущий поиск. Вызывается из потока интерфейса
+ * * @param position - копия движка
+ * * @param request - номер запроса
+ * * @param isDeep - глубокий анализ вместо подсказки на один ход
+ */
+void HintWorker::post(std::unique_ptr<LinesEngine> position, int request, bool isDeep) {
+    position->setListener(nullptr);
+    {
+        QMutexLocker locker(&mutex);
+        pending = std::move(position);
+        pendingRequest = request;
+        pendingDeep = isDeep;
+        cancelled = true;
+    }
+    QMetaObject::invokeMethod(this, "search", Qt::QueuedConnection);
+}
+
+/**
+ * @brief HintWorker::cancel
+ * Отменяет ожидающий и идущий поиск
+ */
+void HintWorker::cancel() {
+    QMutexLocker locker(&mutex);
+    pending.reset();
+    cancelled = true;
+}
+
+/**
+ * @brief HintWorker::search
+ * Ищет ход в последней переданной позиции. Прерванный поиск тоже отдает
+ * лучший найденный ход, его отбросит получатель
+ */
+void HintWorker::search() {
+    Tracer::setThreadName("hint");
+    std::unique_ptr<LinesEngine> position;
+    int request;
+    bool isDeep;
+    {
+        QMutexLocker locker(&mutex);
+        if (!pending)
+            return;
+        position = std::move(pending);
+        request = pendingRequest;
+        isDeep = pendingDeep;
+        cancelled = false;
+    }
+    if (isDeep) {
+        allocateTable();
+        ExpectimaxOptions options;
+        options.depth = ANALYSIS_DEPTH;
+        options.budgetMs = ANALYSIS_BUDGET_MS;
+        ExpectimaxResult result = analysis.search(*position, options, &cancelled);
+        if (result.found)
+            emit found(request, result.move.from, result.move.to);
+        else
+            emit found(request, -1, -1);
+        return;
+    }
+    HintResult result = hintSearch.search(*position, HINT_BUDGET_MS, &cancelled);
+    if (result.score < 0)
+        emit found(request, -1, -1);
+    else
+        emit found(request, result.move.from, result.move.to);
+}
+
+/**
+ * @brief HintWorker::resizeTable
+ * Меняет объем таблицы анализа. Выполняется в потоке поиска, поэтому не пересекается с анализом.
+ * Пока анализа не было, только запоминает объем
+ */
+void HintWorker::resizeTable(int megabytes) {
+    tableMegabytes = qMax(1, megabytes);
+    if (isTableAllocated)
+        table.resize(size_t(tableMegabytes));
+}
+
+/**
+ * @brief HintWorker::allocateTable
+ * Выделяет таблицу анализа при первом анализе, а не при создании модели:
+ * обнуление десятков мегабайт в потоке интерфейса задерживало бы первый кадр
+ */
+void HintWorker::allocateTable() {
+    if (isTableAllocated)
+        return;
+    TRACE_SPAN("HintWorker::allocateTable");
+    table.resize(size_t(tableMegabytes));
+    isTableAllocated = true;
+}
@@ -0,0 +1,62 @@
+#ifndef HINTWORKER_H
+#define HINTWORKER_H
+
+#include <QMutex>
+#include <QObject>
+
+#include <atomic>
+#include <memory>
+
+#include "expectimaxsearch.h"
+#include "hintsearch.h"
+#include "linesengine.h"
+#include "transpositiontable.h"
+#include "workstealingpool.h"
+
+#define HINT_BUDGET_MS     50
+#define ANALYSIS_BUDGET_MS 1000
+#define ANALYSIS_DEPTH     3
+#define ANALYSIS_TABLE_MB  32
+
+/**
+ * Поиск подсказки в собственном потоке: быстрый на один ход либо глубокий анализ
+ * expectimax с таблицей транспозиций, которая сохраняется между анализами.
+ * Позиция передается копией движка,
+ * новая позиция или cancel прерывают уже идущий поиск.
+ * Результат приходит сигналом found с номером запроса, по которому вызывающая сторона
+ * отбрасывает устаревшие ответы
+ */
+class HintWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit HintWorker(QObject *parent = 0);
+
+    void post(std::unique_ptr<LinesEngine> position, int request, bool isDeep);
+    void cancel();
+
+public slots:
+    void search();
+    void resizeTable(int megabytes);
+
+signals:
+    void found(int request, int from, int to);
+
+private:
+    WorkStealingPool             pool;
+    LookaheadHeuristic           heuristic;
+    HintSearch                   hintSearch;
+    TranspositionTable           table;            // минимальная до первого анализа
+    int                          tableMegabytes   = ANALYSIS_TABLE_MB;
+    bool                         isTableAllocated = false;
+    ExpectimaxSearch             analysis;
+    QMutex                       mutex;
+    std::unique_ptr<LinesEngine> pending;
+    int                          pendingRequest = 0;
+    bool                         pendingDeep    = false;
+    std::atomic<bool>            cancelled {false};
+
+    void allocateTable();
+};
+
+#endif // HINTWORKER_H
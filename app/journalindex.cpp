@@ -0,0 +1,53 @@
+#include "journalindex.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+#include "movejournal.h"
+#include "tracer.h"
+
+QString JournalIndex::fileName(const QString& journalName) {
+    return journalName + JOURNAL_INDEX_SUFFIX;
+}
+
+/**
+ * @brief JournalIndex::write
+ * Атомарно заменяет файл смещения. Вызывается после сброса журнала,
+ * чтобы смещение никогда не указывало за его конец
+ * * @param offset - смещение события GAME последней партии
+ */
+void JournalIndex::write(const QString& journalName, qint64 offset) {
+    QSaveFile out(fileName(journalName));
+    if (!out.open(QIODevice::WriteOnly) || out.write(QByteArray::number(offset)) < 0 || !out.commit())
+        qDebug() << "ERROR in JournalIndex::write: " + out.errorString();
+}
+
+/**
+ * @brief JournalIndex::readLastGame
+ * Читает журнал ходов, начиная с последней партии. Если файла смещения нет
+ * или смещение не указывает на начало партии, журнал читается целиком.
+ * Устаревшее смещение безопасно: хвост тогда содержит несколько партий,
+ * и GameRestorer::fromJournal берет последнюю из них
+ * * @return хвост журнала, либо пустой массив, если журнала нет
+ */
+QByteArray JournalIndex::readLastGame(const QString& journalName) {
+    TRACE_SPAN("JournalIndex::readLastGame");
+    QFile file(journalName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QFile index(fileName(journalName));
+    bool isNumber = false;
+    qint64 offset = index.open(QIODevice::ReadOnly) ? index.readAll().trimmed().toLongLong(&isNumber) : 0;
+    if (isNumber && offset > 0 && offset < file.size() && file.seek(offset)) {
+        QByteArray tail = file.readAll();
+        uint64_t seed;
+        int rows, columns;
+        if (MoveJournal::readGame(reinterpret_cast<const uint8_t*>(tail.constData()), size_t(tail.size()),
+                                  seed, rows, columns))
+            return tail;
+        qDebug() << "ERROR in JournalIndex::readLastGame: offset does not point to a game";
+        file.seek(0);
+    }
+    return file.readAll();
+}
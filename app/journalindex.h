@@ -0,0 +1,21 @@
+#ifndef JOURNALINDEX_H
+#define JOURNALINDEX_H
+
+#include <QByteArray>
+#include <QString>
+
+#define JOURNAL_INDEX_SUFFIX ".last"
+
+/**
+ * Смещение начала последней партии в журнале ходов.
+ * Хранится в отдельном файле рядом с журналом, который пишет только писатель,
+ * поэтому при запуске читается один хвост журнала, а не все сыгранные партии
+ */
+class JournalIndex {
+public:
+    static QString    fileName(const QString& journalName);
+    static void       write(const QString& journalName, qint64 offset);
+    static QByteArray readLastGame(const QString& journalName);
+};
+
+#endif // JOURNALINDEX_H
@@ -0,0 +1,142 @@
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+
+#include "boarditem.h"
+#include "database.h"
+#include "gameboard.h"
+#include "highscoremodel.h"
+#include "startupmetrics.h"
+#include "tracer.h"
+
+#include <QCommandLineParser>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QTimer>
+#include <QtQml>
+
+namespace {
+const int GRAB_DELAY_MS = 700;
+}
+
+
+int main(int argc, char *argv[])
+{
+    StartupMetrics::start();
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
+#endif
+
+    QGuiApplication app(argc, argv);
+
+    // формат сохранения: --storage sqlite|snapshot или переменная COLORLINES_STORAGE
+    QCommandLineParser parser;
+    QCommandLineOption storageOption("storage", "Save format: sqlite or snapshot.", "format",
+                                     qEnvironmentVariable("COLORLINES_STORAGE", "sqlite"));
+    QCommandLineOption colorsOption("colors", "Number of ball colors, 1 to 7.", "count", "4");
+    QCommandLineOption rowsOption("rows", "Board rows, 1 to 64.", "count", "9");
+    QCommandLineOption columnsOption("columns", "Board columns, 1 to 64.", "count", "9");
+    QCommandLineOption analysisOption("analysis-mb", "Memory for the analysis transposition table, MB.",
+                                      "megabytes", QString::number(ANALYSIS_TABLE_MB));
+    // трассировка: --trace FILE или переменная COLORLINES_TRACE, файл пишется при выходе
+    QCommandLineOption traceOption("trace", "Write a Chrome trace-event JSON file on exit.", "file",
+                                   qEnvironmentVariable("COLORLINES_TRACE"));
+    // снимок окна: --grab FILE сохраняет кадр после восстановления партии и закрывает приложение,
+    // например для проверки отрисовки с QT_QPA_PLATFORM=offscreen
+    QCommandLineOption grabOption("grab", "Save a window screenshot after the game is restored and quit.", "file");
+    parser.addHelpOption();
+    parser.addOption(storageOption);
+    parser.addOption(colorsOption);
+    parser.addOption(rowsOption);
+    parser.addOption(columnsOption);
+    parser.addOption(analysisOption);
+    parser.addOption(traceOption);
+    parser.addOption(grabOption);
+    parser.process(app);
+
+    const QString traceFile = parser.value(traceOption);
+    if (!traceFile.isEmpty()) {
+        Tracer::setEnabled(true);
+        Tracer::setThreadName("GUI");
+    }
+
+    QQmlApplicationEngine engine;
+    DataBase database;
+    LinesRules rules;
+    rules.colorsCount = parser.value(colorsOption).toInt();
+    int rows = parser.value(rowsOption).toInt();
+    int columns = parser.value(columnsOption).toInt();
+    GameBoard* pBoard = new GameBoard(rules, rows, columns);
+    if (parser.isSet(analysisOption))
+        pBoard->setAnalysisMemory(parser.value(analysisOption).toInt());
+
+    if (parser.value(storageOption) == "snapshot")
+        database.setStorageType(StorageType::SNAPSHOT);
+    database.connectToDB();
+    pBoard->appDb = &database;
+    StartupMetrics::mark("database started");
+
+    // запуск: поле сразу показывает быстрый снимок прошлого выхода, партия восстанавливается
+    // в фоне, пока загружается QML, и применяется после первого кадра
+    if (pBoard->showQuickStart())
+        StartupMetrics::mark("quick start shown");
+    pBoard->beginRestore();
+    // сохраненная партия восстанавливается со своим размером, явно заданный размер начинает новую
+    bool isSizeSet = parser.isSet(rowsOption) || parser.isSet(columnsOption);
+    QObject::connect(pBoard, &GameBoard::restored, &app, [pBoard, isSizeSet, rows, columns]() {
+        if (isSizeSet && (pBoard->rows() != rows || pBoard->columns() != columns))
+            pBoard->resize(rows, columns);
+        StartupMetrics::report();
+    });
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, pBoard, &GameBoard::saveQuickStart);
+
+    // поле рисует один элемент сцены BoardView, модель ему передается свойством board
+    qmlRegisterType<BoardItem>("ColorLines", 1, 0, "BoardView");
+    qmlRegisterUncreatableType<GameBoard>("ColorLines", 1, 0, "GameBoard", "GameBoard is created by the application");
+    engine.rootContext()->setContextProperty("BoardLink", pBoard);
+    HighScoreModel scores;
+    scores.appDb = &database;
+    engine.rootContext()->setContextProperty("DataBaseLink", &database);
+    engine.rootContext()->setContextProperty("ScoresLink", &scores);
+    const QUrl url(QStringLiteral("qrc:/main.qml"));
+    QObject::connect(&engine, &QQmlApplicationEngine::objectCreated,
+                     &app, [url](QObject *obj, const QUrl &objUrl) {
+        if (!obj && url == objUrl)
+            QCoreApplication::exit(-1);
+    }, Qt::QueuedConnection);
+    const QString grabFile = parser.value(grabOption);
+    QObject::connect(&engine, &QQmlApplicationEngine::objectCreated,
+                     pBoard, [url, pBoard, grabFile](QObject *obj, const QUrl &objUrl) {
+        if (!obj || url != objUrl)
+            return;
+        StartupMetrics::mark("qml loaded");
+        QQuickWindow* window = qobject_cast<QQuickWindow*>(obj);
+        if (!window) {
+            pBoard->firstFrameShown();
+            return;
+        }
+        // кадр готов в потоке отрисовки, поэтому соединение очередное
+        QObject::connect(window, &QQuickWindow::frameSwapped, pBoard, &GameBoard::firstFrameShown,
+                         Qt::QueuedConnection);
+        if (grabFile.isEmpty())
+            return;
+        QObject::connect(pBoard, &GameBoard::restored, window, [window, grabFile]() {
+            // дождаться конца анимации появления фигур
+            QTimer::singleShot(GRAB_DELAY_MS, window, [window, grabFile]() {
+                if (!window->grabWindow().save(grabFile)) {
+                    qDebug() << "ERROR in main: cannot save screenshot" << grabFile;
+                    QCoreApplication::exit(1);
+                    return;
+                }
+                QCoreApplication::quit();
+            });
+        });
+    });
+
+    engine.load(url);
+
+    int result = app.exec();
+    if (!traceFile.isEmpty() && !Tracer::writeChromeTrace(traceFile.toStdString()))
+        qDebug() << "ERROR in main: cannot write trace" << traceFile;
+    return result;
+}
@@ -0,0 +1,423 @@
+import QtQuick 2.6
+import QtQuick.Window 2.15
+import QtQuick.Controls 2.2
+import QtQuick.Controls.Styles 1.4
+import ColorLines 1.0
+
+Window {
+    width  : 1000
+    height : 800
+    visible: true
+    title  : qsTr("Color Lines")
+
+    QtObject {
+        id : d
+        property int mainMargin : 50
+        property int boardSide  : 450
+        property int gridSize   : Math.floor(Math.min(boardSide / BoardLink.columns,
+                                                      boardSide / BoardLink.rows))
+    }
+
+    Rectangle {
+        id          : backgroud
+        anchors.fill: parent
+        color       : "#ffead2"
+        Rectangle {
+            id          : titleRect
+            height      : 150
+            width       : 640
+            radius      : 20
+            border.color: "brown"
+            anchors {
+                top             : parent.top
+                topMargin       : 50
+                horizontalCenter: parent.horizontalCenter
+            }
+            color : "white"
+
+            RoundButton {
+                id : newGameButton
+                anchors {
+                    verticalCenter: parent.verticalCenter
+                    left          : parent.left
+                    leftMargin    : 20
+                }
+                width  : 150
+                height : 70
+                radius : 20
+
+                visible        : true
+                enabled        : !BoardLink.isRestoring
+                font.pixelSize : 20
+                text           : "NEW GAME"
+                onClicked: {
+                    BoardLink.newGame();
+                }
+            }
+
+            Rectangle {
+                id    : finalRect
+                width : 210
+                height: 120
+                color : "white"
+                radius: 20
+
+                border {
+                    color: "grey"
+                    width: 2
+                }
+                anchors.centerIn: parent
+                Text {
+                    id              : finalText
+                    anchors.centerIn: parent
+                    font.pixelSize  : 18
+                    text            : qsTr("Game OVER!\nYou scored a "+
+                                            BoardLink.currentScore+
+                                            " points!\nClick New game")
+                }
+            }
+
+            Row {
+                id            : textScore
+                width         : textScore.childrenRect.width
+                anchors {
+                    verticalCenter: parent.verticalCenter
+                    right         : parent.right
+                    rightMargin   : 20
+                }
+
+                Text {
+                    id            : textScoreLine
+                    width         : contentWidth
+                    text          : "Score: "
+                    color         : "black"
+                    font.pixelSize: 45
+                }
+
+                Text {
+                    id            : textScoreInfo
+                    width         : contentWidth
+                    text          : BoardLink.currentScore
+                    color         : "black"
+                    font.pixelSize: 45
+
+                    onTextChanged: {
+                        seqAnim.start();
+                    }
+
+                    SequentialAnimation {
+                        id: seqAnim
+                        property real yText : textScore.y
+                        NumberAnimation {
+                            target    : textScoreInfo
+                            properties: "opacity"
+                            from      : 1
+                            to        : 0.3
+                            duration  : 200
+                        }
+
+                        NumberAnimation {
+                            target    : textScoreInfo
+                            properties: "opacity"
+                            from      : 0.3
+                            to        : 1
+                            duration  : 1000
+                        }
+                    }
+                }
+            }
+        }
+
+        // поле целиком: ячейки, фигуры, щелчки и анимация хода рисует один элемент сцены
+        BoardView {
+            id     : gameBoard
+            board  : BoardLink
+            enabled: !BoardLink.isRestoring
+            width  : d.gridSize * BoardLink.columns
+            height : d.gridSize * BoardLink.rows
+            anchors {
+                top             : titleRect.bottom
+                topMargin       : 50
+                horizontalCenter: parent.horizontalCenter
+            }
+        }
+
+        RoundButton {
+            id : undoButton
+            anchors {
+                top             : gameBoard.bottom
+                topMargin       : 20
+                right           : hintButton.left
+                rightMargin     : 20
+            }
+            width  : 110
+            height : 50
+            radius : 20
+
+            enabled        : BoardLink.canUndo && !BoardLink.turnBusy && !BoardLink.isRestoring
+            font.pixelSize : 18
+            text           : "UNDO"
+            onClicked: {
+                gameBoard.clearSelection();
+                BoardLink.undo();
+            }
+        }
+
+        RoundButton {
+            id : redoButton
+            anchors {
+                top             : gameBoard.bottom
+                topMargin       : 20
+                left            : analysisButton.right
+                leftMargin      : 20
+            }
+            width  : 110
+            height : 50
+            radius : 20
+
+            enabled        : BoardLink.canRedo && !BoardLink.turnBusy && !BoardLink.isRestoring
+            font.pixelSize : 18
+            text           : "REDO"
+            onClicked: {
+                gameBoard.clearSelection();
+                BoardLink.redo();
+            }
+        }
+
+        RoundButton {
+            id : hintButton
+            anchors {
+                top             : gameBoard.bottom
+                topMargin       : 20
+                right           : parent.horizontalCenter
+                rightMargin     : 10
+            }
+            width  : 150
+            height : 50
+            radius : 20
+
+            enabled        : !BoardLink.isFinal && !BoardLink.isRestoring
+            font.pixelSize : 18
+            text           : BoardLink.hintBusy ? "CANCEL" : "HINT"
+            onClicked: {
+                if (BoardLink.hintBusy)
+                    BoardLink.cancelHint();
+                else
+                    BoardLink.requestHint();
+            }
+        }
+
+        RoundButton {
+            id : analysisButton
+            anchors {
+                top             : gameBoard.bottom
+                topMargin       : 20
+                left            : parent.horizontalCenter
+                leftMargin      : 10
+            }
+            width  : 150
+            height : 50
+            radius : 20
+
+            enabled        : !BoardLink.isFinal && !BoardLink.hintBusy && !BoardLink.isRestoring
+            font.pixelSize : 18
+            text           : "ANALYZE"
+            onClicked: {
+                BoardLink.requestAnalysis();
+            }
+        }
+
+        Column {
+            id      : sessionButtons
+            spacing : 20
+            anchors {
+                top        : gameBoard.top
+                right      : gameBoard.left
+                rightMargin: 40
+            }
+
+            RoundButton {
+                width  : 130
+                height : 50
+                radius : 20
+
+                enabled        : !BoardLink.turnBusy && !BoardLink.isRestoring
+                font.pixelSize : 18
+                text           : "SAVE"
+                onClicked: {
+                    slotsPopup.isSaving = true;
+                    slotsPopup.open();
+                }
+            }
+
+            RoundButton {
+                width  : 130
+                height : 50
+                radius : 20
+
+                enabled        : !BoardLink.turnBusy && !BoardLink.isRestoring
+                font.pixelSize : 18
+                text           : "LOAD"
+                onClicked: {
+                    slotsPopup.isSaving = false;
+                    slotsPopup.open();
+                }
+            }
+
+            RoundButton {
+                width  : 130
+                height : 50
+                radius : 20
+
+                font.pixelSize : 18
+                text           : "SCORES"
+                onClicked: {
+                    scoresPopup.open();
+                }
+            }
+        }
+
+        // слоты сохранения: заголовки перечитываются при каждом открытии
+        Popup {
+            id     : slotsPopup
+            property bool isSaving: true
+            property var  saveSlots: []
+
+            width  : 520
+            height : 560
+            x      : (parent.width - width) / 2
+            y      : (parent.height - height) / 2
+            modal  : true
+            focus  : true
+
+            onAboutToShow: {
+                slotsPopup.saveSlots = DataBaseLink.listSaveSlots();
+            }
+
+            Column {
+                anchors.fill: parent
+                spacing     : 10
+
+                Text {
+                    font.pixelSize: 22
+                    text          : slotsPopup.isSaving ? "Save to slot" : "Load from slot"
+                }
+
+                Repeater {
+                    model: slotsPopup.saveSlots
+
+                    Row {
+                        spacing: 10
+
+                        Button {
+                            width  : 420
+                            height : 50
+                            enabled: slotsPopup.isSaving || modelData.isUsed
+                            text   : modelData.isUsed
+                                     ? "Slot " + modelData.slot + ":  " + modelData.score + " points,  " +
+                                       modelData.rows + "x" + modelData.columns + ",  " + modelData.savedAt
+                                     : "Slot " + modelData.slot + ":  empty"
+                            onClicked: {
+                                gameBoard.clearSelection();
+                                if (slotsPopup.isSaving)
+                                    BoardLink.saveToSlot(modelData.slot);
+                                else
+                                    BoardLink.loadFromSlot(modelData.slot);
+                                slotsPopup.close();
+                            }
+                        }
+
+                        Button {
+                            width  : 50
+                            height : 50
+                            visible: modelData.isUsed
+                            text   : "X"
+                            onClicked: {
+                                DataBaseLink.deleteSlot(modelData.slot);
+                                slotsPopup.saveSlots = DataBaseLink.listSaveSlots();
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // таблица рекордов: ListView сам дочитывает страницы модели при прокрутке
+        Popup {
+            id     : scoresPopup
+            width  : 520
+            height : 600
+            x      : (parent.width - width) / 2
+            y      : (parent.height - height) / 2
+            modal  : true
+            focus  : true
+
+            onAboutToShow: {
+                ScoresLink.refresh();
+            }
+
+            Text {
+                id            : scoresTitle
+                font.pixelSize: 22
+                text          : "High scores"
+            }
+
+            ListView {
+                id   : scoresList
+                clip : true
+                model: ScoresLink
+                anchors {
+                    top      : scoresTitle.bottom
+                    topMargin: 10
+                    left     : parent.left
+                    right    : parent.right
+                    bottom   : parent.bottom
+                }
+
+                delegate: Row {
+                    spacing: 20
+                    height : 32
+
+                    Text { width: 50;  font.pixelSize: 18; text: rank }
+                    Text { width: 80;  font.pixelSize: 18; text: score }
+                    Text { width: 80;  font.pixelSize: 18; text: moves + " mv" }
+                    Text { width: 60;  font.pixelSize: 18; text: board }
+                    Text { font.pixelSize: 18; color: "grey"; text: finishedAt }
+                }
+            }
+        }
+
+        Text {
+            id            : textPersistenceStats
+            anchors {
+                left        : parent.left
+                bottom      : parent.bottom
+                leftMargin  : 10
+                bottomMargin: 10
+            }
+            color         : "grey"
+            font.pixelSize: 12
+            text          : "DB queue: " + DataBaseLink.queueDepth +
+                            "  last flush: " + DataBaseLink.flushLatency + " us"
+        }
+
+        states: [
+            State {
+                name: "GameOver"
+                when: BoardLink.isFinal
+                PropertyChanges {
+                    target  : finalRect
+                    visible : true
+                }
+            },
+            State {
+                name: "GameContinues"
+                when: !BoardLink.isFinal
+                PropertyChanges {
+                    target  : finalRect
+                    visible : false
+                }
+            }
+        ]
+    }
+}
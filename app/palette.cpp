@@ -0,0 +1,53 @@
+#include "palette.h"
+
+namespace {
+
+struct PaletteCache {
+    QColor   colors[PALETTE_SIZE];
+    QVariant colorValues[PALETTE_SIZE];
+    QVariant busyValues[2];
+
+    PaletteCache() {
+        for (int i = 0; i < PALETTE_SIZE; ++i) {
+            colors[i] = QColor::fromRgba(PALETTE_RGB[i]);
+            colorValues[i] = QVariant::fromValue(colors[i]);
+        }
+        busyValues[0] = QVariant(false);
+        busyValues[1] = QVariant(true);
+    }
+};
+
+const PaletteCache& cache() {
+    static const PaletteCache instance;
+    return instance;
+}
+
+int clampColor(int idColor) {
+    return (idColor < 0 || idColor >= PALETTE_SIZE) ? 0 : idColor;
+}
+
+} // namespace
+
+/**
+ * @brief Palette::color
+ * * @return цвет фигуры; для неизвестного id - прозрачный
+ */
+const QColor& Palette::color(int idColor) {
+    return cache().colors[clampColor(idColor)];
+}
+
+/**
+ * @brief Palette::colorValue
+ * * @return готовое значение роли cellColor
+ */
+const QVariant& Palette::colorValue(int idColor) {
+    return cache().colorValues[clampColor(idColor)];
+}
+
+/**
+ * @brief Palette::busyValue
+ * * @return готовое значение роли cellIsBusy
+ */
+const QVariant& Palette::busyValue(bool isBusy) {
+    return cache().busyValues[isBusy ? 1 : 0];
+}
@@ -0,0 +1,39 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <QColor>
+#include <QVariant>
+
+#include "linesengine.h"
+
+#define PALETTE_SIZE (LinesEngine::MAX_COLORS + 1)
+
+/**
+ * Цвета фигур по id цвета в формате ARGB, нулевой - прозрачный (пустая ячейка)
+ */
+constexpr QRgb PALETTE_RGB[] = {
+    0x00000000,  // COLORLESS
+    0xFFA57C56,  // RED
+    0xFFA4B787,  // GREEN
+    0xFFB3D6D4,  // BLUE
+    0xFFFCD582,  // YELLOW
+    0xFFC39BC4,  // VIOLET
+    0xFFE8A09A,  // CORAL
+    0xFF8FA6C9   // NAVY
+};
+
+static_assert(sizeof(PALETTE_RGB) / sizeof(PALETTE_RGB[0]) == PALETTE_SIZE,
+              "palette must have an entry for every engine color");
+
+/**
+ * Палитра с заранее построенными значениями для модели:
+ * data() отдает копии готовых QVariant без разбора строк и выделения памяти
+ */
+class Palette {
+public:
+    static const QColor&   color(int idColor);
+    static const QVariant& colorValue(int idColor);
+    static const QVariant& busyValue(bool isBusy);
+};
+
+#endif // PALETTE_H
@@ -0,0 +1,92 @@
+#include "persistenceworker.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include "journalindex.h"
+#include "tracer.h"
+
+PersistenceWorker::PersistenceWorker(PersistenceQueue* queue, StorageType storageType,
+                                     const QString& journalName, const QString& scoresName,
+                                     QObject *parent)
+    : QObject(parent),
+      queue(queue),
+      storageType(storageType),
+      journal(journalName),
+      scores(scoresName, SCORES_CONNECTION) {
+}
+
+PersistenceWorker::~PersistenceWorker() {
+    delete storage;
+}
+
+/**
+ * @brief PersistenceWorker::start
+ * Открывает собственный экземпляр хранилища, журнал ходов и таблицу рекордов
+ * и запускает таймер сброса.
+ * Вызывается уже в потоке писателя
+ */
+void PersistenceWorker::start() {
+    Tracer::setThreadName("persistence");
+    storage = createStorageBackend(storageType, WRITER_CONNECTION);
+    storage->open();
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append))
+        qDebug() << "ERROR in PersistenceWorker::start: " + journal.errorString();
+    scores.open();
+
+    flushTimer = new QTimer(this);
+    flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    connect(flushTimer, &QTimer::timeout, this, &PersistenceWorker::flush);
+    flushTimer->start();
+}
+
+/**
+ * @brief PersistenceWorker::flush
+ * Записывает все накопленные в очереди пакеты одной транзакцией
+ */
+void PersistenceWorker::flush() {
+    TRACE_SPAN("PersistenceWorker::flush");
+    PersistenceBatch* batch;
+    if (!queue->pop(batch))
+        return;
+    QElapsedTimer timer;
+    timer.start();
+    storage->beginBatch();
+    int ops = 0;
+    do {
+        for (const PersistenceOp& op : *batch) {
+            ScoreRecord record;
+            if (op.type == PersistenceOp::AppendJournal) {
+                if (op.first >= 0)
+                    gameStart = journal.pos() + op.first;
+                journal.write(op.payload);
+            }
+            else if (op.type == PersistenceOp::RecordScore && ScoreRecord::fromBytes(op.payload, record))
+                scores.insert(record);
+            else
+                storage->apply(op);
+        }
+        ops += batch->size();
+        delete batch;
+    } while (queue->pop(batch));
+    storage->commitBatch();
+    journal.flush();
+    if (gameStart >= 0)
+        JournalIndex::write(journal.fileName(), gameStart);
+    gameStart = -1;
+    emit flushed(ops, timer.nsecsElapsed() / 1000);
+}
+
+/**
+ * @brief PersistenceWorker::stop
+ * Сбрасывает остаток очереди и закрывает хранилище
+ */
+void PersistenceWorker::stop() {
+    if (flushTimer)
+        flushTimer->stop();
+    flush();
+    delete storage;
+    storage = nullptr;
+    journal.close();
+    scores.close();
+}
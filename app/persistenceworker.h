@@ -0,0 +1,50 @@
+#ifndef PERSISTENCEWORKER_H
+#define PERSISTENCEWORKER_H
+
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+
+#include "scoretable.h"
+#include "spscqueue.h"
+#include "storagebackend.h"
+
+#define WRITER_CONNECTION  "ColorLinesWriter"
+#define SCORES_CONNECTION  "ColorLinesScoresWriter"
+#define FLUSH_INTERVAL_MS  250
+
+typedef SpscQueue<PersistenceBatch*, 1024> PersistenceQueue;
+
+/**
+ * Фоновый писатель: живет в собственном потоке со своим экземпляром хранилища,
+ * забирает пакеты из очереди и записывает их по таймеру или по запросу в конце хода.
+ * События журнала ходов дописываются в конец отдельного файла, смещение последней
+ * партии в нем - в JournalIndex, результаты законченных партий - в таблицу рекордов
+ */
+class PersistenceWorker : public QObject
+{
+    Q_OBJECT
+public:
+    PersistenceWorker(PersistenceQueue* queue, StorageType storageType, const QString& journalName,
+                      const QString& scoresName, QObject *parent = 0);
+    ~PersistenceWorker();
+
+public slots:
+    void start();
+    void flush();
+    void stop();
+
+signals:
+    void flushed(int ops, qint64 latencyUs);
+
+private:
+    PersistenceQueue* queue;
+    StorageType       storageType;
+    StorageBackend*   storage    = nullptr;
+    QFile             journal;
+    qint64            gameStart  = -1;  // смещение новой партии в журнале, еще не записанное в индекс
+    ScoreTable        scores;
+    QTimer*           flushTimer = nullptr;
+};
+
+#endif // PERSISTENCEWORKER_H
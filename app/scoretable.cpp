@@ -0,0 +1,196 @@
+#include "scoretable.h"
+
+#include <QDataStream>
+#include <QSqlError>
+#include <QDebug>
+
+#include "tracer.h"
+
+/**
+ * @brief ScoreRecord::toBytes
+ * Упаковывает запись для передачи писателю в операции RecordScore
+ */
+QByteArray ScoreRecord::toBytes() const {
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << qint32(score) << qint32(moves) << qint32(rows) << qint32(columns) << seed << finishedAt;
+    return bytes;
+}
+
+bool ScoreRecord::fromBytes(const QByteArray& bytes, ScoreRecord& record) {
+    QDataStream in(bytes);
+    qint32 score, moves, rows, columns;
+    in >> score >> moves >> rows >> columns >> record.seed >> record.finishedAt;
+    if (in.status() != QDataStream::Ok)
+        return false;
+    record.score = score;
+    record.moves = moves;
+    record.rows = rows;
+    record.columns = columns;
+    return true;
+}
+
+ScoreTable::ScoreTable(const QString& dbName, const QString& connectionName)
+    : dbName(dbName),
+      connectionName(connectionName) {
+}
+
+ScoreTable::~ScoreTable() {
+    close();
+}
+
+/**
+ * @brief ScoreTable::open
+ * Открывает соединение, создает таблицу и индекс, если их нет, и подготавливает запросы
+ * * @return true, если соединение открыто
+ */
+bool ScoreTable::open() {
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(dbName);
+    if (!db.open()) {
+        qDebug() << "ERROR in ScoreTable::open: " + db.lastError().text();
+        return false;
+    }
+    QSqlQuery pragma(db);
+    pragma.exec("PRAGMA journal_mode = WAL");
+    pragma.exec("PRAGMA synchronous = NORMAL");
+    createTable();
+    prepareQueries();
+    return true;
+}
+
+void ScoreTable::close() {
+    if (!db.isValid())
+        return;
+    insertQuery = QSqlQuery();
+    firstPageQuery = QSqlQuery();
+    sameScoreQuery = QSqlQuery();
+    lowerScoreQuery = QSqlQuery();
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+bool ScoreTable::createTable() {
+    QString highScores = ( "CREATE TABLE IF NOT EXISTS " TABLE_SCORES " (     \n"
+                                "id            INTEGER PRIMARY KEY,        \n"
+                                "score         INTEGER NOT NULL,           \n"
+                                "moves         INTEGER NOT NULL,           \n"
+                                "board_rows    INTEGER NOT NULL,           \n"
+                                "board_columns INTEGER NOT NULL,           \n"
+                                "seed          INTEGER NOT NULL,           \n"
+                                "finished_at   INTEGER NOT NULL )          \n"
+                          );
+    QString scoreIndex = ( "CREATE INDEX IF NOT EXISTS " TABLE_SCORES "ByScore \n"
+                           "ON " TABLE_SCORES " (score DESC, id)                \n"
+                         );
+    QSqlQuery query(db);
+    bool res1 = query.exec(highScores);
+    if (!res1)
+        qDebug() << "ERROR in ScoreTable::createTable: " + query.lastError().text();
+    bool res2 = query.exec(scoreIndex);
+    if (!res2)
+        qDebug() << "ERROR in ScoreTable::createTable: " + query.lastError().text();
+    return res1 && res2;
+}
+
+/**
+ * @brief ScoreTable::prepareQueries
+ * Подготавливает вставку и запросы страниц. Продолжение страницы разбито на два диапазона
+ * индекса - остаток записей с тем же счетом и записи с меньшим счетом, - так как условие
+ * с OR SQLite не всегда умеет пройти одним диапазоном в порядке индекса
+ * * @return true, если все запросы подготовлены
+ */
+bool ScoreTable::prepareQueries() {
+    bool res1 = prepareSQL(insertQuery,
+                           " INSERT INTO " TABLE_SCORES
+                           " (score, moves, board_rows, board_columns, seed, finished_at) "
+                           " values(:score, :moves, :rows, :columns, :seed, :finishedAt) ");
+    bool res2 = prepareSQL(firstPageQuery,
+                           " SELECT id, score, moves, board_rows, board_columns, seed, finished_at "
+                           " FROM " TABLE_SCORES
+                           " ORDER BY score DESC, id LIMIT :limit ");
+    bool res3 = prepareSQL(sameScoreQuery,
+                           " SELECT id, score, moves, board_rows, board_columns, seed, finished_at "
+                           " FROM " TABLE_SCORES
+                           " WHERE score = :score AND id > :id "
+                           " ORDER BY score DESC, id LIMIT :limit ");
+    bool res4 = prepareSQL(lowerScoreQuery,
+                           " SELECT id, score, moves, board_rows, board_columns, seed, finished_at "
+                           " FROM " TABLE_SCORES
+                           " WHERE score < :score "
+                           " ORDER BY score DESC, id LIMIT :limit ");
+    return res1 && res2 && res3 && res4;
+}
+
+bool ScoreTable::insert(const ScoreRecord& record) {
+    TRACE_SPAN("ScoreTable::insert");
+    insertQuery.bindValue(":score", record.score);
+    insertQuery.bindValue(":moves", record.moves);
+    insertQuery.bindValue(":rows", record.rows);
+    insertQuery.bindValue(":columns", record.columns);
+    insertQuery.bindValue(":seed", qint64(record.seed));
+    insertQuery.bindValue(":finishedAt", record.finishedAt);
+    return execPrepared(insertQuery);
+}
+
+int ScoreTable::loadPage(const ScoreRecord* after, int limit, QVector<ScoreRecord>& page) {
+    TRACE_SPAN("ScoreTable::loadPage");
+    if (limit <= 0)
+        return 0;
+    if (!after) {
+        firstPageQuery.bindValue(":limit", limit);
+        return readPage(firstPageQuery, page);
+    }
+    sameScoreQuery.bindValue(":score", after->score);
+    sameScoreQuery.bindValue(":id", after->id);
+    sameScoreQuery.bindValue(":limit", limit);
+    int count = readPage(sameScoreQuery, page);
+    if (count >= limit)
+        return count;
+    lowerScoreQuery.bindValue(":score", after->score);
+    lowerScoreQuery.bindValue(":limit", limit - count);
+    return count + readPage(lowerScoreQuery, page);
+}
+
+int ScoreTable::readPage(QSqlQuery& query, QVector<ScoreRecord>& page) {
+    if (!execPrepared(query))
+        return 0;
+    int count = 0;
+    while (query.next()) {
+        ScoreRecord record;
+        record.id = query.value(0).toLongLong();
+        record.score = query.value(1).toInt();
+        record.moves = query.value(2).toInt();
+        record.rows = query.value(3).toInt();
+        record.columns = query.value(4).toInt();
+        record.seed = query.value(5).toULongLong();
+        record.finishedAt = query.value(6).toLongLong();
+        page.append(record);
+        ++count;
+    }
+    query.finish();
+    return count;
+}
+
+bool ScoreTable::prepareSQL(QSqlQuery& query, const QString text) {
+    query = QSqlQuery(db);
+    query.setForwardOnly(true);
+    bool res = query.prepare(text);
+    if (!res)
+        qDebug() << "ERROR in ScoreTable::prepareSQL: " + query.lastError().text() << " \n"
+                 << "WITH query: " << text;
+    return res;
+}
+
+bool ScoreTable::execPrepared(QSqlQuery& query) {
+    if (db.isOpen()) {
+        bool res = query.exec();
+        if (!res)
+            qDebug() << "ERROR in ScoreTable::execPrepared: " + query.lastError().text() << " \n"
+                     << "WITH query: " << query.lastQuery();
+        return res;
+    }
+    qDebug() << "ERROR in ScoreTable::execPrepared: DataBase in not open";
+    return false;
+}
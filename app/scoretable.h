@@ -0,0 +1,70 @@
+#ifndef SCORETABLE_H
+#define SCORETABLE_H
+
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVector>
+
+#define TABLE_SCORES "HighScores"
+
+/**
+ * Запись таблицы рекордов об одной законченной партии
+ */
+struct ScoreRecord {
+    qint64  id         = 0;  // номер записи, назначается при вставке
+    int     score      = 0;
+    int     moves      = 0;
+    int     rows       = 0;
+    int     columns    = 0;
+    quint64 seed       = 0;
+    qint64  finishedAt = 0;  // секунды от начала эпохи
+
+    QByteArray  toBytes() const;
+    static bool fromBytes(const QByteArray& bytes, ScoreRecord& record);
+};
+
+/**
+ * Таблица рекордов в отдельном файле SQLite, общем для обоих форматов сохранения.
+ * Записи упорядочены индексом по (score DESC, id), поэтому страница лучших результатов
+ * читается одним диапазоном индекса от последней показанной записи, без OFFSET
+ * и без обхода всей таблицы. Каждый поток работает со своим экземпляром
+ */
+class ScoreTable {
+public:
+    ScoreTable(const QString& dbName, const QString& connectionName);
+    ~ScoreTable();
+
+    bool open();
+    void close();
+
+    bool insert(const ScoreRecord& record);
+
+    /**
+     * @brief ScoreTable::loadPage
+     * Читает следующую страницу таблицы рекордов в порядке убывания счета
+     * * @param after - последняя прочитанная запись, nullptr - начать с лучшей
+     * * @param limit - наибольшее число записей
+     * * @param page - дополняется прочитанными записями
+     * * @return количество прочитанных записей
+     */
+    int loadPage(const ScoreRecord* after, int limit, QVector<ScoreRecord>& page);
+
+private:
+    QString      dbName;
+    QString      connectionName;
+    QSqlDatabase db;
+
+    QSqlQuery insertQuery;
+    QSqlQuery firstPageQuery;
+    QSqlQuery sameScoreQuery;
+    QSqlQuery lowerScoreQuery;
+
+    bool createTable();
+    bool prepareQueries();
+    bool prepareSQL(QSqlQuery& query, const QString text);
+    bool execPrepared(QSqlQuery& query);
+    int  readPage(QSqlQuery& query, QVector<ScoreRecord>& page);
+};
+
+#endif // SCORETABLE_H
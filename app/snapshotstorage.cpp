@@ -0,0 +1,295 @@
+#include "snapshotstorage.h"
+
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QDebug>
+
+#include <cstddef>
+#include <cstring>
+
+#include "tracer.h"
+
+SnapshotStorage::SnapshotStorage(const QString& fileName)
+    : file(fileName) {
+}
+
+SnapshotStorage::~SnapshotStorage() {
+    close();
+}
+
+/**
+ * @brief SnapshotStorage::open
+ * Открывает файл снимка (создает при отсутствии) и отображает его в память
+ * * @return true, если файл отображен
+ */
+bool SnapshotStorage::open() {
+    if (!file.open(QIODevice::ReadWrite)) {
+        qDebug() << "ERROR in SnapshotStorage::open: " + file.errorString();
+        return false;
+    }
+    const qint64 size = 2 * sizeof(SnapshotSlot);
+    if (file.size() < size && !file.resize(size)) {
+        qDebug() << "ERROR in SnapshotStorage::open: " + file.errorString();
+        return false;
+    }
+    mapped = reinterpret_cast<SnapshotSlot*>(file.map(0, size));
+    if (!mapped) {
+        qDebug() << "ERROR in SnapshotStorage::open: " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void SnapshotStorage::close() {
+    if (!mapped)
+        return;
+    commitBatch();
+    file.unmap(reinterpret_cast<uchar*>(mapped));
+    mapped = nullptr;
+    file.close();
+}
+
+/**
+ * @brief SnapshotStorage::beginBatch
+ * Копирует последний корректный слот во второй слот, куда будут применяться операции пакета
+ */
+void SnapshotStorage::beginBatch() {
+    if (!mapped || working)
+        return;
+    const SnapshotSlot* active = activeSlot();
+    working = (active == &mapped[0]) ? &mapped[1] : &mapped[0];
+    if (active) {
+        std::memcpy(working, active, offsetof(SnapshotSlot, cells) + (active->cellCount + 1) / 2);
+        return;
+    }
+    std::memset(working, 0, sizeof(SnapshotSlot));
+    working->magic = SNAPSHOT_MAGIC;
+    working->version = SNAPSHOT_VERSION;
+}
+
+/**
+ * @brief SnapshotStorage::commitBatch
+ * Делает рабочий слот действующим: увеличивает номер и записывает контрольную сумму последней
+ */
+void SnapshotStorage::commitBatch() {
+    TRACE_SPAN("SnapshotStorage::commitBatch");
+    if (!working)
+        return;
+    const SnapshotSlot* active = activeSlot();
+    working->sequence = active ? active->sequence + 1 : 1;
+    working->checksum = checksum(*working);
+    working = nullptr;
+}
+
+void SnapshotStorage::apply(const PersistenceOp& op) {
+    TRACE_SPAN("SnapshotStorage::apply");
+    if (!working)
+        return;
+    switch (op.type) {
+    case PersistenceOp::InsertPosition:
+    case PersistenceOp::UpdatePosition:
+        if (op.id < 0 || op.id >= SNAPSHOT_CAPACITY)
+            break;
+        setCell(*working, op.id, int(op.first), op.second != 0);
+        if (op.id >= working->cellCount)
+            working->cellCount = quint16(op.id + 1);
+        break;
+    case PersistenceOp::InsertInfo:
+        working->flags |= HasInformation;
+        working->score = 0;
+        working->seed = quint64(op.first);
+        working->randomState = quint64(op.first);
+        working->rows = 0;
+        working->columns = 0;
+        working->savedAt = 0;
+        break;
+    case PersistenceOp::UpdateScore:
+        working->score = qint32(op.first);
+        break;
+    case PersistenceOp::UpdateRandomState:
+        working->randomState = quint64(op.first);
+        break;
+    case PersistenceOp::UpdateGeometry:
+        working->rows = quint16(op.first);
+        working->columns = quint16(op.second);
+        break;
+    case PersistenceOp::ClearPositions:
+        std::memset(working->cells, 0, (working->cellCount + 1) / 2);
+        working->cellCount = 0;
+        break;
+    case PersistenceOp::ClearInformation:
+        working->flags &= ~quint32(HasInformation);
+        break;
+    case PersistenceOp::SaveSlot:
+        saveSlot(op.id, op.first);
+        break;
+    case PersistenceOp::DeleteSlot:
+        if (op.id > LIVE_SLOT && op.id <= SLOT_COUNT)
+            QFile::remove(slotFileName(op.id));
+        break;
+    case PersistenceOp::AppendJournal:
+    case PersistenceOp::RecordScore:
+        // журнал ходов и таблицу рекордов пишет сам писатель
+        break;
+    }
+}
+
+/**
+ * @brief SnapshotStorage::saveSlot
+ * Записывает рабочий слот, то есть текущую партию с уже примененными операциями пакета,
+ * в файл слота игрока. Файл заменяется атомарно
+ * * @param slot - номер слота, 1..SLOT_COUNT
+ * * @param savedAt - время сохранения, секунды от начала эпохи
+ */
+void SnapshotStorage::saveSlot(int slot, qint64 savedAt) {
+    if (slot <= LIVE_SLOT || slot > SLOT_COUNT)
+        return;
+    SnapshotSlot copy;
+    const size_t size = offsetof(SnapshotSlot, cells) + (working->cellCount + 1) / 2;
+    std::memcpy(&copy, working, size);
+    copy.sequence = 0;
+    copy.savedAt = quint32(savedAt);
+    copy.checksum = checksum(copy);
+    QSaveFile out(slotFileName(slot));
+    if (!out.open(QIODevice::WriteOnly) ||
+            out.write(reinterpret_cast<const char*>(&copy), qint64(size)) != qint64(size) || !out.commit())
+        qDebug() << "ERROR in SnapshotStorage::saveSlot: " + out.errorString();
+}
+
+/**
+ * @brief SnapshotStorage::loadPositions
+ * Распаковывает ячейки прямо из отображенного слота, либо из файла слота игрока
+ * * @param visitor - получатель ячеек
+ * * @param slot - номер слота, LIVE_SLOT - текущая партия
+ * * @return количество прочитанных ячеек
+ */
+int SnapshotStorage::loadPositions(const CellVisitor& visitor, int slot) {
+    TRACE_SPAN("SnapshotStorage::loadPositions");
+    SnapshotSlot buffer;
+    const SnapshotSlot* active = readSlot(slot, buffer);
+    if (!active)
+        return 0;
+    for (int id = 0; id < active->cellCount; ++id) {
+        quint8 cell = (active->cells[id / 2] >> ((id % 2) * 4)) & 0xF;
+        visitor(id, cell & 0x7, (cell & 0x8) != 0);
+    }
+    return active->cellCount;
+}
+
+bool SnapshotStorage::loadInformation(SavedInformation& info, int slot) {
+    TRACE_SPAN("SnapshotStorage::loadInformation");
+    SnapshotSlot buffer;
+    const SnapshotSlot* active = readSlot(slot, buffer);
+    if (!active || !(active->flags & HasInformation))
+        return false;
+    info.score = active->score;
+    info.seed = active->seed;
+    info.randomState = active->randomState;
+    info.rows = active->rows;
+    info.columns = active->columns;
+    info.savedAt = active->savedAt;
+    return true;
+}
+
+QJsonArray SnapshotStorage::readPositions() {
+    QJsonArray retQuery;
+    const SnapshotSlot* active = activeSlot();
+    if (!active)
+        return retQuery;
+    for (int id = 0; id < active->cellCount; ++id) {
+        quint8 cell = (active->cells[id / 2] >> ((id % 2) * 4)) & 0xF;
+        QJsonObject row;
+        row.insert("id", QString::number(id));
+        row.insert("color_cell", QString::number(cell & 0x7));
+        row.insert("is_busy_cell", QString::number((cell >> 3) & 0x1));
+        retQuery.append(row);
+    }
+    return retQuery;
+}
+
+QJsonArray SnapshotStorage::readInformation() {
+    QJsonArray retQuery;
+    const SnapshotSlot* active = activeSlot();
+    if (!active || !(active->flags & HasInformation))
+        return retQuery;
+    QJsonObject row;
+    row.insert("id", QString::number(0));
+    row.insert("score", QString::number(active->score));
+    row.insert("seed", QString::number(qint64(active->seed)));
+    row.insert("random_state", QString::number(qint64(active->randomState)));
+    row.insert("board_rows", QString::number(active->rows));
+    row.insert("board_columns", QString::number(active->columns));
+    retQuery.append(row);
+    return retQuery;
+}
+
+/**
+ * @brief SnapshotStorage::activeSlot
+ * * @return корректный слот с наибольшим номером, либо nullptr
+ */
+const SnapshotSlot* SnapshotStorage::activeSlot() const {
+    if (!mapped)
+        return nullptr;
+    const SnapshotSlot* active = nullptr;
+    for (int i = 0; i < 2; ++i) {
+        const SnapshotSlot& slot = mapped[i];
+        if (&slot == working || !isValid(slot))
+            continue;
+        if (!active || slot.sequence > active->sequence)
+            active = &slot;
+    }
+    return active;
+}
+
+/**
+ * @brief SnapshotStorage::readSlot
+ * * @param slot - номер слота, LIVE_SLOT - текущая партия
+ * * @param buffer - место для слота, прочитанного из файла слота игрока
+ * * @return корректный слот, либо nullptr
+ */
+const SnapshotSlot* SnapshotStorage::readSlot(int slot, SnapshotSlot& buffer) const {
+    if (slot == LIVE_SLOT)
+        return activeSlot();
+    if (slot < LIVE_SLOT || slot > SLOT_COUNT)
+        return nullptr;
+    QFile in(slotFileName(slot));
+    if (!in.open(QIODevice::ReadOnly))
+        return nullptr;
+    std::memset(&buffer, 0, sizeof(SnapshotSlot));
+    in.read(reinterpret_cast<char*>(&buffer), sizeof(SnapshotSlot));
+    return isValid(buffer) ? &buffer : nullptr;
+}
+
+QString SnapshotStorage::slotFileName(int slot) const {
+    return file.fileName() + "." + QString::number(slot);
+}
+
+bool SnapshotStorage::isValid(const SnapshotSlot& slot) const {
+    return slot.magic == SNAPSHOT_MAGIC && slot.version == SNAPSHOT_VERSION &&
+            slot.cellCount <= SNAPSHOT_CAPACITY && slot.checksum == checksum(slot);
+}
+
+/**
+ * @brief SnapshotStorage::checksum
+ * FNV-1a по заголовку (кроме самой суммы) и занятой части ячеек
+ */
+quint32 SnapshotStorage::checksum(const SnapshotSlot& slot) {
+    const uchar* bytes = reinterpret_cast<const uchar*>(&slot);
+    const size_t sumBegin = offsetof(SnapshotSlot, checksum);
+    const size_t sumEnd = sumBegin + sizeof(slot.checksum);
+    const size_t end = offsetof(SnapshotSlot, cells) + (slot.cellCount + 1) / 2;
+    quint32 hash = 2166136261u;
+    for (size_t i = 0; i < end; ++i) {
+        if (i >= sumBegin && i < sumEnd)
+            continue;
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void SnapshotStorage::setCell(SnapshotSlot& slot, int id, int color, bool isBusy) {
+    quint8 value = quint8((color & 0x7) | (isBusy ? 0x8 : 0));
+    int shift = (id % 2) * 4;
+    slot.cells[id / 2] = quint8((slot.cells[id / 2] & ~(0xF << shift)) | (value << shift));
+}
@@ -0,0 +1,82 @@
+#ifndef SNAPSHOTSTORAGE_H
+#define SNAPSHOTSTORAGE_H
+
+#include <QFile>
+
+#include "storagebackend.h"
+
+#define SNAPSHOT_MAGIC    0x4E534C43u
+#define SNAPSHOT_VERSION  2
+#define SNAPSHOT_CAPACITY 4096
+#define SNAPSHOT_PAGE     4096
+
+/**
+ * Слот двоичного снимка: заголовок и упакованные ячейки (4 бита на ячейку: цвет и занятость).
+ * Контрольная сумма покрывает заголовок без нее самой и занятую часть ячеек.
+ * Слот выровнен на страницу и занимает ее целиком, поэтому фиксация пакета
+ * меняет ровно одну страницу файла при любом размере поля
+ */
+struct alignas(SNAPSHOT_PAGE) SnapshotSlot {
+    quint32 magic;
+    quint16 version;
+    quint16 cellCount;
+    quint32 sequence;
+    quint32 checksum;
+    qint32  score;
+    quint32 flags;
+    quint16 rows;
+    quint16 columns;
+    quint32 savedAt;  // время сохранения слота игрока, секунды от начала эпохи
+    quint64 seed;
+    quint64 randomState;
+    quint8  cells[SNAPSHOT_CAPACITY / 2];
+};
+
+static_assert(sizeof(SnapshotSlot) == SNAPSHOT_PAGE, "snapshot slot must fill exactly one page");
+
+/**
+ * Хранилище в виде версионированного снимка с контрольной суммой в отображенном в память файле.
+ * Файл содержит два слота: пакет применяется к копии последнего корректного слота
+ * и фиксируется записью номера и контрольной суммы, поэтому оборванная запись
+ * не портит предыдущее сохранение. Каждый слот - своя страница файла, так что
+ * пакет любого поля до 64x64 пишет одну страницу.
+ * Слоты сохранения игрока - отдельные файлы <файл>.<слот> с копией одного слота,
+ * они пишутся редко и заменяются целиком
+ */
+class SnapshotStorage : public StorageBackend {
+public:
+    explicit SnapshotStorage(const QString& fileName);
+    ~SnapshotStorage();
+
+    bool open() override;
+    void close() override;
+
+    void beginBatch() override;
+    void apply(const PersistenceOp& op) override;
+    void commitBatch() override;
+
+    int  loadPositions(const CellVisitor& visitor, int slot = LIVE_SLOT) override;
+    bool loadInformation(SavedInformation& info, int slot = LIVE_SLOT) override;
+
+    QJsonArray readPositions() override;
+    QJsonArray readInformation() override;
+
+private:
+    enum Flags {
+        HasInformation = 0x1
+    };
+
+    QFile         file;
+    SnapshotSlot* mapped  = nullptr;
+    SnapshotSlot* working = nullptr;
+
+    const SnapshotSlot* activeSlot() const;
+    const SnapshotSlot* readSlot(int slot, SnapshotSlot& buffer) const;
+    QString             slotFileName(int slot) const;
+    void                saveSlot(int slot, qint64 savedAt);
+    bool                isValid(const SnapshotSlot& slot) const;
+    static quint32      checksum(const SnapshotSlot& slot);
+    static void         setCell(SnapshotSlot& slot, int id, int color, bool isBusy);
+};
+
+#endif // SNAPSHOTSTORAGE_H
@@ -0,0 +1,399 @@
+#include "sqlitestorage.h"
+
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QDebug>
+
+#include "tracer.h"
+
+SqliteStorage::SqliteStorage(const QString& dbName, const QString& connectionName)
+    : dbName(dbName),
+      connectionName(connectionName) {
+}
+
+SqliteStorage::~SqliteStorage() {
+    close();
+}
+
+/**
+ * @brief SqliteStorage::open
+ * Открывает соединение, при отсутствии файла создает таблицы,
+ * включает журнал WAL и подготавливает запросы записи
+ * * @return true, если соединение открыто
+ */
+bool SqliteStorage::open() {
+    bool isNew = !QFile(dbName).exists();
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(dbName);
+    if (!db.open()) {
+        qDebug() << "ERROR in SqliteStorage::open: " + db.lastError().text();
+        return false;
+    }
+    if (isNew)
+        createTables();
+    querySQL("PRAGMA journal_mode = WAL");
+    querySQL("PRAGMA synchronous = NORMAL");
+    prepareQueries();
+    return true;
+}
+
+void SqliteStorage::close() {
+    if (!db.isValid())
+        return;
+    commitBatch();
+    insertPositionQuery = QSqlQuery();
+    insertInfoQuery = QSqlQuery();
+    updatePositionQuery = QSqlQuery();
+    updateScoreQuery = QSqlQuery();
+    updateRandomStateQuery = QSqlQuery();
+    updateGeometryQuery = QSqlQuery();
+    clearPositionsQuery = QSqlQuery();
+    clearInformationQuery = QSqlQuery();
+    loadPositionsQuery = QSqlQuery();
+    loadInformationQuery = QSqlQuery();
+    copyPositionsQuery = QSqlQuery();
+    copyInformationQuery = QSqlQuery();
+    deleteSlotPositionsQuery = QSqlQuery();
+    deleteSlotInformationQuery = QSqlQuery();
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+/**
+ * @brief SqliteStorage::createTables
+ * Создает таблицы сессий. Ячейки лежат в таблице без rowid с ключом (сессия, ячейка),
+ * поэтому партия любого слота читается и копируется одним диапазоном ключа
+ * * @return true, если таблицы созданы
+ */
+bool SqliteStorage::createTables() {
+    QString sessionPositions = ( "CREATE TABLE " TABLE_POSITIONS " (               \n"
+                                        "session      INTEGER   NOT NULL,          \n"
+                                        "id           INTEGER   NOT NULL,          \n"
+                                        "color_cell   INTEGER   NOT NULL,          \n"
+                                        "is_busy_cell bool      NOT NULL,          \n"
+                                        "PRIMARY KEY (session, id) ) WITHOUT ROWID \n"
+                                );
+    QString sessionInformation = ( "CREATE TABLE " TABLE_INFO " (                  \n"
+                                        "session       INTEGER PRIMARY KEY,        \n"
+                                        "score         INTEGER,                    \n"
+                                        "seed          INTEGER,                    \n"
+                                        "random_state  INTEGER,                    \n"
+                                        "board_rows    INTEGER,                    \n"
+                                        "board_columns INTEGER,                    \n"
+                                        "saved_at      INTEGER DEFAULT 0)          \n"
+                                  );
+    bool res1 = querySQL(sessionPositions);
+    bool res2 = querySQL(sessionInformation);
+    return res1 && res2;
+}
+
+/**
+ * @brief SqliteStorage::prepareQueries
+ * Подготавливает запросы, которые выполняются на каждом ходе и при загрузке.
+ * Вызывается после создания таблиц, так как SQLite проверяет их наличие при подготовке.
+ * Запросы хода меняют только текущую партию - сессию 0
+ * * @return true, если все запросы подготовлены
+ */
+bool SqliteStorage::prepareQueries() {
+    bool res1 = prepareSQL(insertPositionQuery,
+                           " INSERT INTO " TABLE_POSITIONS
+                           " (session, id, color_cell, is_busy_cell) "
+                           " values(0, :id, :color, :busy) ");
+    bool res2 = prepareSQL(insertInfoQuery,
+                           " INSERT INTO " TABLE_INFO
+                           " (session, score, seed, random_state) "
+                           " values(0, 0, :seed, :seed) ");
+    bool res3 = prepareSQL(updatePositionQuery,
+                           " UPDATE " TABLE_POSITIONS
+                           " SET color_cell = :color, is_busy_cell = :busy "
+                           " WHERE session = 0 AND id = :id ");
+    bool res4 = prepareSQL(updateScoreQuery,
+                           " UPDATE " TABLE_INFO
+                           " SET score = :score "
+                           " WHERE session = 0 ");
+    bool res5 = prepareSQL(updateRandomStateQuery,
+                           " UPDATE " TABLE_INFO
+                           " SET random_state = :state "
+                           " WHERE session = 0 ");
+    bool res6 = prepareSQL(clearPositionsQuery, " DELETE FROM " TABLE_POSITIONS " WHERE session = 0 ");
+    bool res7 = prepareSQL(clearInformationQuery, " DELETE FROM " TABLE_INFO " WHERE session = 0 ");
+    bool res8 = prepareSQL(loadPositionsQuery,
+                           " SELECT id, color_cell, is_busy_cell FROM " TABLE_POSITIONS
+                           " WHERE session = :session ORDER BY id ");
+    bool res9 = prepareSQL(loadInformationQuery,
+                           " SELECT score, seed, random_state, board_rows, board_columns, saved_at "
+                           " FROM " TABLE_INFO " WHERE session = :session ");
+    bool res10 = prepareSQL(updateGeometryQuery,
+                            " UPDATE " TABLE_INFO
+                            " SET board_rows = :rows, board_columns = :columns "
+                            " WHERE session = 0 ");
+    bool res11 = prepareSQL(copyPositionsQuery,
+                            " INSERT INTO " TABLE_POSITIONS
+                            " (session, id, color_cell, is_busy_cell) "
+                            " SELECT :session, id, color_cell, is_busy_cell FROM " TABLE_POSITIONS
+                            " WHERE session = 0 ");
+    bool res12 = prepareSQL(copyInformationQuery,
+                            " INSERT OR REPLACE INTO " TABLE_INFO
+                            " (session, score, seed, random_state, board_rows, board_columns, saved_at) "
+                            " SELECT :session, score, seed, random_state, board_rows, board_columns, :savedAt "
+                            " FROM " TABLE_INFO " WHERE session = 0 ");
+    bool res13 = prepareSQL(deleteSlotPositionsQuery,
+                            " DELETE FROM " TABLE_POSITIONS " WHERE session = :session ");
+    bool res14 = prepareSQL(deleteSlotInformationQuery,
+                            " DELETE FROM " TABLE_INFO " WHERE session = :session ");
+    return res1 && res2 && res3 && res4 && res5 && res6 && res7 && res8 && res9 && res10 &&
+            res11 && res12 && res13 && res14;
+}
+
+void SqliteStorage::beginBatch() {
+    if (inTransaction || !db.isOpen())
+        return;
+    inTransaction = db.transaction();
+}
+
+void SqliteStorage::commitBatch() {
+    TRACE_SPAN("SqliteStorage::commitBatch");
+    if (!inTransaction)
+        return;
+    inTransaction = false;
+    if (!db.commit()) {
+        qDebug() << "ERROR in SqliteStorage::commitBatch: " + db.lastError().text();
+        db.rollback();
+    }
+}
+
+void SqliteStorage::apply(const PersistenceOp& op) {
+    switch (op.type) {
+    case PersistenceOp::InsertPosition:
+        insertPositionQuery.bindValue(":id", op.id);
+        insertPositionQuery.bindValue(":color", op.first);
+        insertPositionQuery.bindValue(":busy", op.second);
+        execPrepared(insertPositionQuery);
+        break;
+    case PersistenceOp::UpdatePosition:
+        updatePositionQuery.bindValue(":id", op.id);
+        updatePositionQuery.bindValue(":color", op.first);
+        updatePositionQuery.bindValue(":busy", op.second);
+        execPrepared(updatePositionQuery);
+        break;
+    case PersistenceOp::InsertInfo:
+        insertInfoQuery.bindValue(":seed", op.first);
+        execPrepared(insertInfoQuery);
+        break;
+    case PersistenceOp::UpdateScore:
+        updateScoreQuery.bindValue(":score", op.first);
+        execPrepared(updateScoreQuery);
+        break;
+    case PersistenceOp::UpdateRandomState:
+        updateRandomStateQuery.bindValue(":state", op.first);
+        execPrepared(updateRandomStateQuery);
+        break;
+    case PersistenceOp::UpdateGeometry:
+        updateGeometryQuery.bindValue(":rows", op.first);
+        updateGeometryQuery.bindValue(":columns", op.second);
+        execPrepared(updateGeometryQuery);
+        break;
+    case PersistenceOp::ClearPositions:
+        execPrepared(clearPositionsQuery);
+        break;
+    case PersistenceOp::ClearInformation:
+        execPrepared(clearInformationQuery);
+        break;
+    case PersistenceOp::SaveSlot:
+        saveSlot(op.id, op.first);
+        break;
+    case PersistenceOp::DeleteSlot:
+        deleteSlot(op.id);
+        break;
+    case PersistenceOp::AppendJournal:
+    case PersistenceOp::RecordScore:
+        // журнал ходов и таблицу рекордов пишет сам писатель
+        break;
+    }
+}
+
+/**
+ * @brief SqliteStorage::saveSlot
+ * Копирует текущую партию в слот внутри базы, не передавая ячейки через приложение
+ * * @param slot - номер слота, 1..SLOT_COUNT
+ * * @param savedAt - время сохранения, секунды от начала эпохи
+ */
+void SqliteStorage::saveSlot(int slot, qint64 savedAt) {
+    if (slot <= LIVE_SLOT || slot > SLOT_COUNT)
+        return;
+    deleteSlot(slot);
+    copyPositionsQuery.bindValue(":session", slot);
+    execPrepared(copyPositionsQuery);
+    copyInformationQuery.bindValue(":session", slot);
+    copyInformationQuery.bindValue(":savedAt", savedAt);
+    execPrepared(copyInformationQuery);
+}
+
+void SqliteStorage::deleteSlot(int slot) {
+    if (slot <= LIVE_SLOT || slot > SLOT_COUNT)
+        return;
+    deleteSlotPositionsQuery.bindValue(":session", slot);
+    execPrepared(deleteSlotPositionsQuery);
+    deleteSlotInformationQuery.bindValue(":session", slot);
+    execPrepared(deleteSlotInformationQuery);
+}
+
+/**
+ * @brief SqliteStorage::loadPositions
+ * Читает ячейки подготовленным запросом и передает их получателю
+ * без промежуточного текстового представления
+ * * @param visitor - получатель ячеек
+ * * @param slot - номер слота, LIVE_SLOT - текущая партия
+ * * @return количество прочитанных строк
+ */
+int SqliteStorage::loadPositions(const CellVisitor& visitor, int slot) {
+    TRACE_SPAN("SqliteStorage::loadPositions");
+    loadPositionsQuery.bindValue(":session", slot);
+    if (!execPrepared(loadPositionsQuery))
+        return 0;
+    int count = 0;
+    while (loadPositionsQuery.next()) {
+        visitor(loadPositionsQuery.value(0).toInt(),
+                loadPositionsQuery.value(1).toInt(),
+                loadPositionsQuery.value(2).toInt() != 0);
+        ++count;
+    }
+    loadPositionsQuery.finish();
+    return count;
+}
+
+/**
+ * @brief SqliteStorage::loadInformation
+ * * @param info - заполняется сохраненной информацией о партии
+ * * @param slot - номер слота, LIVE_SLOT - текущая партия
+ * * @return true, если информация сохранена
+ */
+bool SqliteStorage::loadInformation(SavedInformation& info, int slot) {
+    TRACE_SPAN("SqliteStorage::loadInformation");
+    loadInformationQuery.bindValue(":session", slot);
+    if (!execPrepared(loadInformationQuery))
+        return false;
+    bool res = loadInformationQuery.next();
+    if (res) {
+        info.score = loadInformationQuery.value(0).toInt();
+        info.seed = loadInformationQuery.value(1).toULongLong();
+        info.randomState = loadInformationQuery.value(2).toULongLong();
+        info.rows = loadInformationQuery.value(3).toInt();
+        info.columns = loadInformationQuery.value(4).toInt();
+        info.savedAt = loadInformationQuery.value(5).toLongLong();
+    }
+    loadInformationQuery.finish();
+    return res;
+}
+
+QJsonArray SqliteStorage::readPositions() {
+    QString queryStr = (" SELECT * FROM " TABLE_POSITIONS " WHERE session = 0 ");
+    return querySQLJS(queryStr);
+}
+
+QJsonArray SqliteStorage::readInformation() {
+    QString queryStr = (" SELECT * FROM " TABLE_INFO " WHERE session = 0 ");
+    return querySQLJS(queryStr);
+}
+
+/**
+ * @brief SqliteStorage::querySQL
+ * Делает запрос к базе
+ * * @param query - текст запроса
+ * * @return true, если запрос выполнился без ошибок
+ */
+bool SqliteStorage::querySQL(const QString query) {
+    TRACE_SPAN("SqliteStorage::querySQL");
+    if (db.isOpen()) {
+        QSqlQuery querySQL(db);
+        bool res;
+        querySQL.setForwardOnly(true);
+        res = querySQL.exec(query);
+
+        if (!res) {
+            qDebug() << "ERROR in querySQL: " + querySQL.lastError().text() << " \n"
+                     << "WITH query: " << query;
+            return res;
+        }
+        return res;
+    }
+    qDebug() << "ERROR in querySQL: DataBase in not open";
+    return false;
+}
+
+/**
+ * @brief SqliteStorage::prepareSQL
+ * Подготавливает запрос для многократного выполнения с разными параметрами
+ * * @param query - объект запроса
+ * * @param text - текст запроса с именованными параметрами
+ * * @return true, если запрос подготовлен без ошибок
+ */
+bool SqliteStorage::prepareSQL(QSqlQuery& query, const QString text) {
+    query = QSqlQuery(db);
+    query.setForwardOnly(true);
+    bool res = query.prepare(text);
+    if (!res)
+        qDebug() << "ERROR in prepareSQL: " + query.lastError().text() << " \n"
+                 << "WITH query: " << text;
+    return res;
+}
+
+/**
+ * @brief SqliteStorage::execPrepared
+ * Выполняет подготовленный запрос с привязанными параметрами
+ * * @param query - подготовленный запрос
+ * * @return true, если запрос выполнился без ошибок
+ */
+bool SqliteStorage::execPrepared(QSqlQuery& query) {
+    TRACE_SPAN("SqliteStorage::execPrepared");
+    if (db.isOpen()) {
+        bool res = query.exec();
+        if (!res)
+            qDebug() << "ERROR in execPrepared: " + query.lastError().text() << " \n"
+                     << "WITH query: " << query.lastQuery();
+        return res;
+    }
+    qDebug() << "ERROR in execPrepared: DataBase in not open";
+    return false;
+}
+
+/**
+ * @brief SqliteStorage::querySQLJS
+ * Делает запрос с возвращаемым значением
+ * * @param query - текст запроса
+ * * @return массив ответа на запрос
+ */
+QJsonArray SqliteStorage::querySQLJS(const QString query) {
+    TRACE_SPAN("SqliteStorage::querySQLJS");
+    QJsonArray retQuery;
+    if (db.isOpen()) {
+        QSqlQuery querySQL(db);
+        bool res;
+        querySQL.setForwardOnly(true);
+        res = querySQL.exec(query);
+        if (!res) {
+            qDebug() << "ERROR in querySQLJS: " + querySQL.lastError().text() << " \n"
+                     << "WITH query: " << query;
+            return retQuery;
+        }
+        QSqlRecord fields = querySQL.record();
+        while (querySQL.next()){
+            QVariantMap Jline;
+            for (int i = 0 ;i < fields.count(); ++i)
+                if (querySQL.value(i).isNull()) {
+                    Jline.insert(fields.fieldName(i), "");
+                }
+                else {
+                    Jline.insert(fields.fieldName(i), querySQL.value(i).toString());
+                }
+            retQuery.append(QJsonValue(QJsonObject::fromVariantMap(Jline)));
+        }
+        return retQuery;
+    }
+    qDebug() << "ERROR in querySQLJS: DataBase in not open";
+    return retQuery;
+}
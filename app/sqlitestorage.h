@@ -0,0 +1,66 @@
+#ifndef SQLITESTORAGE_H
+#define SQLITESTORAGE_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "storagebackend.h"
+
+#define TABLE_INFO      "SessionInformation"
+#define TABLE_POSITIONS "SessionPositions"
+
+/**
+ * Хранилище в SQLite: по строке на ячейку и строка с информацией о партии.
+ * Строки ключуются номером сессии: 0 - текущая партия, остальные - слоты сохранения
+ */
+class SqliteStorage : public StorageBackend {
+public:
+    SqliteStorage(const QString& dbName, const QString& connectionName);
+    ~SqliteStorage();
+
+    bool open() override;
+    void close() override;
+
+    void beginBatch() override;
+    void apply(const PersistenceOp& op) override;
+    void commitBatch() override;
+
+    int  loadPositions(const CellVisitor& visitor, int slot = LIVE_SLOT) override;
+    bool loadInformation(SavedInformation& info, int slot = LIVE_SLOT) override;
+
+    QJsonArray readPositions() override;
+    QJsonArray readInformation() override;
+
+private:
+    QString      dbName;
+    QString      connectionName;
+    QSqlDatabase db;
+    bool         inTransaction {false};
+
+    QSqlQuery insertPositionQuery;
+    QSqlQuery insertInfoQuery;
+    QSqlQuery updatePositionQuery;
+    QSqlQuery updateScoreQuery;
+    QSqlQuery updateRandomStateQuery;
+    QSqlQuery updateGeometryQuery;
+    QSqlQuery clearPositionsQuery;
+    QSqlQuery clearInformationQuery;
+    QSqlQuery loadPositionsQuery;
+    QSqlQuery loadInformationQuery;
+    QSqlQuery copyPositionsQuery;
+    QSqlQuery copyInformationQuery;
+    QSqlQuery deleteSlotPositionsQuery;
+    QSqlQuery deleteSlotInformationQuery;
+
+    bool       querySQL(const QString query);
+    QJsonArray querySQLJS(const QString query);
+    bool       prepareSQL(QSqlQuery& query, const QString text);
+    bool       execPrepared(QSqlQuery& query);
+
+    bool createTables();
+    bool prepareQueries();
+    void saveSlot(int slot, qint64 savedAt);
+    void deleteSlot(int slot);
+};
+
+#endif // SQLITESTORAGE_H
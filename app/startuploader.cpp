@@ -0,0 +1,38 @@
+#include "startuploader.h"
+
+#include <memory>
+
+#include "journalindex.h"
+#include "tracer.h"
+
+StartupLoader::StartupLoader(StorageType storageType, const QString& journalName,
+                             const LinesRules& rules, QObject *parent)
+    : QObject(parent),
+      storageType(storageType),
+      journalName(journalName),
+      rules(rules) {
+}
+
+/**
+ * @brief StartupLoader::load
+ * Восстанавливает последнюю партию. Хранилище открывается, только если журнала нет
+ * или он поврежден. Вызывается уже в потоке загрузки
+ */
+void StartupLoader::load() {
+    Tracer::setThreadName("startup");
+    TRACE_SPAN("StartupLoader::load");
+    if (!GameRestorer::fromJournal(JournalIndex::readLastGame(journalName), rules, result)) {
+        std::unique_ptr<StorageBackend> storage(createStorageBackend(storageType, STARTUP_CONNECTION));
+        if (storage->open())
+            GameRestorer::fromStorage(*storage, rules, result);
+    }
+    emit loaded();
+}
+
+/**
+ * @brief StartupLoader::takeResult
+ * Отдает восстановленную партию. Вызывается после сигнала loaded
+ */
+RestoredGame StartupLoader::takeResult() {
+    return std::move(result);
+}
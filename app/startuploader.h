@@ -0,0 +1,39 @@
+#ifndef STARTUPLOADER_H
+#define STARTUPLOADER_H
+
+#include <QObject>
+#include <QString>
+
+#include "gamerestorer.h"
+
+#define STARTUP_CONNECTION "ColorLinesStartup"
+
+/**
+ * Фоновое восстановление при запуске: живет в собственном потоке,
+ * открывает свой экземпляр хранилища, читает журнал ходов и восстанавливает партию,
+ * пока поток интерфейса загружает QML.
+ * Результат забирается в потоке интерфейса после сигнала loaded
+ */
+class StartupLoader : public QObject
+{
+    Q_OBJECT
+public:
+    StartupLoader(StorageType storageType, const QString& journalName, const LinesRules& rules,
+                  QObject *parent = 0);
+
+    RestoredGame takeResult();
+
+public slots:
+    void load();
+
+signals:
+    void loaded();
+
+private:
+    StorageType  storageType;
+    QString      journalName;
+    LinesRules   rules;
+    RestoredGame result;
+};
+
+#endif // STARTUPLOADER_H
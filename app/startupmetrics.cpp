@@ -0,0 +1,46 @@
+#include "startupmetrics.h"
+
+#include <QDebug>
+#include <QStringList>
+
+#include "tracer.h"
+
+QElapsedTimer                 StartupMetrics::timer;
+quint64                       StartupMetrics::origin = 0;
+QVector<StartupMetrics::Phase> StartupMetrics::phases;
+
+/**
+ * @brief StartupMetrics::start
+ * Начинает отсчет. Вызывается первой строкой main
+ */
+void StartupMetrics::start() {
+    timer.start();
+    origin = Tracer::now();
+    phases.clear();
+}
+
+/**
+ * @brief StartupMetrics::mark
+ * Отмечает завершение фазы запуска
+ * * @param phase - имя фазы, строковый литерал
+ */
+void StartupMetrics::mark(const char* phase) {
+    if (!timer.isValid())
+        return;
+    qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+    phases.append({phase, elapsedUs});
+    if (Tracer::isEnabled())
+        Tracer::record(phase, origin, Tracer::now());
+    qDebug() << "startup:" << phase << elapsedUs / 1000.0 << "ms";
+}
+
+/**
+ * @brief StartupMetrics::report
+ * Выводит все фазы одной строкой
+ */
+void StartupMetrics::report() {
+    QStringList parts;
+    for (const Phase& phase : phases)
+        parts.append(QString("%1 %2 ms").arg(phase.name).arg(phase.elapsedUs / 1000.0, 0, 'f', 1));
+    qDebug() << "startup summary:" << qPrintable(parts.join(", "));
+}
@@ -0,0 +1,29 @@
+#ifndef STARTUPMETRICS_H
+#define STARTUPMETRICS_H
+
+#include <QElapsedTimer>
+#include <QVector>
+
+/**
+ * Замеры запуска: время от начала main до каждой фазы.
+ * Фазы пишутся в отладочный вывод, а при включенной трассировке - интервалами
+ * от начала запуска, чтобы их было видно рядом с работой потоков
+ */
+class StartupMetrics {
+public:
+    static void start();
+    static void mark(const char* phase);
+    static void report();
+
+private:
+    struct Phase {
+        const char* name;
+        qint64      elapsedUs;
+    };
+
+    static QElapsedTimer  timer;
+    static quint64        origin;
+    static QVector<Phase> phases;
+};
+
+#endif // STARTUPMETRICS_H
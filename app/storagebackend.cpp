@@ -0,0 +1,34 @@
+#include "storagebackend.h"
+
+#include "database.h"
+#include "snapshotstorage.h"
+#include "sqlitestorage.h"
+
+/**
+ * @brief createStorageBackend
+ * Создает хранилище заданного типа
+ * * @param connectionName - имя соединения, уникальное для потока
+ */
+StorageBackend* createStorageBackend(StorageType type, const QString& connectionName) {
+    switch (type) {
+    case StorageType::SNAPSHOT:
+        return new SnapshotStorage(storageName(type));
+    case StorageType::SQLITE:
+        break;
+    }
+    return new SqliteStorage(storageName(type), connectionName);
+}
+
+/**
+ * @brief storageName
+ * * @return имя файла хранилища заданного типа
+ */
+QString storageName(StorageType type) {
+    switch (type) {
+    case StorageType::SNAPSHOT:
+        return NAME_SNAPSHOT;
+    case StorageType::SQLITE:
+        break;
+    }
+    return NAME_BASE;
+}
@@ -0,0 +1,97 @@
+#ifndef STORAGEBACKEND_H
+#define STORAGEBACKEND_H
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * Одна операция записи в хранилище
+ */
+struct PersistenceOp {
+    enum Type {
+        InsertPosition,
+        UpdatePosition,
+        InsertInfo,
+        UpdateScore,
+        UpdateRandomState,
+        UpdateGeometry,
+        ClearPositions,
+        ClearInformation,
+        AppendJournal, // события журнала в payload, first - начало партии в payload, либо -1
+        SaveSlot,      // копия текущей партии в слот id, first - время сохранения
+        DeleteSlot,    // удаление слота id
+        RecordScore    // запись в таблицу рекордов, payload - ScoreRecord::toBytes
+    };
+
+    Type       type;
+    int        id;
+    qint64     first;
+    qint64     second;
+    QByteArray payload;
+};
+
+/**
+ * Пакет операций, записываемый одной транзакцией (обычно - один ход)
+ */
+typedef QVector<PersistenceOp> PersistenceBatch;
+
+/**
+ * Сохраненная информация о партии
+ */
+struct SavedInformation {
+    int     score       = 0;
+    quint64 seed        = 0;
+    quint64 randomState = 0;
+    int     rows        = 0;
+    int     columns     = 0;
+    qint64  savedAt     = 0;  // время сохранения слота, секунды от начала эпохи
+};
+
+/**
+ * Получатель сохраненных ячеек: вызывается по одному разу на каждую строку
+ */
+typedef std::function<void(int id, int color, bool isBusy)> CellVisitor;
+
+enum class StorageType {
+    SQLITE,
+    SNAPSHOT
+};
+
+/**
+ * Хранилище сохраненной партии. Каждый поток работает со своим экземпляром:
+ * поток интерфейса читает, фоновый писатель применяет пакеты операций.
+ * Текущая партия лежит в слоте LIVE_SLOT и обновляется каждым ходом,
+ * слоты сохранения 1..SLOT_COUNT - копии, сделанные игроком
+ */
+class StorageBackend {
+public:
+    enum {
+        LIVE_SLOT  = 0,
+        SLOT_COUNT = 8
+    };
+
+    virtual ~StorageBackend() {}
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    virtual void beginBatch() = 0;
+    virtual void apply(const PersistenceOp& op) = 0;
+    virtual void commitBatch() = 0;
+
+    virtual int  loadPositions(const CellVisitor& visitor, int slot = LIVE_SLOT) = 0;
+    virtual bool loadInformation(SavedInformation& info, int slot = LIVE_SLOT) = 0;
+
+    // текстовое представление сохранения, только для диагностики
+    virtual QJsonArray readPositions() = 0;
+    virtual QJsonArray readInformation() = 0;
+};
+
+StorageBackend* createStorageBackend(StorageType type, const QString& connectionName);
+QString storageName(StorageType type);
+
+#endif // STORAGEBACKEND_H
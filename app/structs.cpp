@@ -0,0 +1,14 @@
+#include "structs.h"
+
+int Cell::getNumColor() const {
+    return static_cast<int>(color);
+}
+
+const QColor& Cell::getColor() const {
+    return Palette::color(getNumColor());
+}
+
+void Cell::setColor(int id) {
+    if (id >= 0 && id < PALETTE_SIZE)
+        color = static_cast<ColorEnum>(id);
+}
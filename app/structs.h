@@ -3,21 +3,26 @@
 
 #include <QObject>
 
+#include "palette.h"
+
 enum class ColorEnum {
     COLORLESS = 0,
     RED = 1,
     GREEN = 2,
     BLUE = 3,
-    YELLOW = 4
+    YELLOW = 4,
+    VIOLET = 5,
+    CORAL = 6,
+    NAVY = 7
 };
 
 struct Cell {
     ColorEnum color = ColorEnum::COLORLESS;
     bool isBusy     = false;
 
-    QString getStrColor() const;
-    int     getNumColor() const;
-    void    setColor(int id);
+    const QColor& getColor() const;
+    int           getNumColor() const;
+    void          setColor(int id);
 
 };
 
@@ -0,0 +1,88 @@
+#include "turnworker.h"
+
+#include "tracer.h"
+
+TurnWorker::TurnWorker(QObject *parent)
+    : QObject(parent) {
+}
+
+/**
+ * @brief TurnWorker::post
+ * Передает ход для розыгрыша, заменяя еще не начатый. Вызывается из потока интерфейса
+ * * @param position - копия движка до хода
+ * * @param move - ход игрока
+ * * @param request - номер запроса
+ */
+void TurnWorker::post(std::unique_ptr<LinesEngine> position, const Move& move, int request) {
+    position->setListener(nullptr);
+    {
+        QMutexLocker locker(&mutex);
+        pending = std::move(position);
+        pendingMove = move;
+        pendingRequest = request;
+    }
+    QMetaObject::invokeMethod(this, "resolve", Qt::QueuedConnection);
+}
+
+/**
+ * @brief TurnWorker::cancel
+ * Отменяет еще не начатый розыгрыш. Уже начатый доигрывается, его итог отбросит получатель
+ */
+void TurnWorker::cancel() {
+    QMutexLocker locker(&mutex);
+    pending.reset();
+}
+
+/**
+ * @brief TurnWorker::takeResult
+ * Отдает итог хода, если он относится к запросу request. Вызывается после сигнала resolved
+ * * @return false - если итог устарел или уже забран
+ */
+bool TurnWorker::takeResult(int request, TurnResult& taken) {
+    QMutexLocker locker(&mutex);
+    if (result.request != request)
+        return false;
+    taken = std::move(result);
+    result = TurnResult();
+    return true;
+}
+
+/**
+ * @brief TurnWorker::resolve
+ * Разыгрывает последний переданный ход. Изменения записывает собственная история,
+ * из нее же берется итог: перемещение отдельно от ответа компьютера, чтобы модель
+ * могла показать его до конца анимации
+ */
+void TurnWorker::resolve() {
+    Tracer::setThreadName("turn");
+    std::unique_ptr<LinesEngine> position;
+    TurnResult resolvedTurn;
+    {
+        QMutexLocker locker(&mutex);
+        if (!pending)
+            return;
+        position = std::move(pending);
+        resolvedTurn.move = pendingMove;
+        resolvedTurn.request = pendingRequest;
+    }
+    TRACE_SPAN("TurnWorker::resolve");
+    const Move& move = resolvedTurn.move;
+    if (position->shortestPath(move.from, move.to, resolvedTurn.path) > 0) {
+        recorder.clear();
+        position->setListener(&recorder);
+        recorder.beginTurn(*position);
+        position->moveAlong(resolvedTurn.path);
+        const int moveChanges = recorder.recordedChanges();
+        position->endTurn(move.to);
+        recorder.endTurn(*position);
+        recorder.lastTurn(resolvedTurn.delta);
+        resolvedTurn.delta.moveChanges = size_t(moveChanges);
+        resolvedTurn.delta.spawned = position->spawned();
+    }
+    const int request = resolvedTurn.request;
+    {
+        QMutexLocker locker(&mutex);
+        result = std::move(resolvedTurn);
+    }
+    emit resolved(request);
+}
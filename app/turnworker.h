@@ -0,0 +1,56 @@
+#ifndef TURNWORKER_H
+#define TURNWORKER_H
+
+#include <QMutex>
+#include <QObject>
+
+#include <memory>
+#include <vector>
+
+#include "linesengine.h"
+#include "undostack.h"
+
+/**
+ * Итог хода игрока, разыгранного в потоке ходов
+ */
+struct TurnResult {
+    int              request = 0;
+    Move             move;
+    std::vector<int> path;    // путь фигуры, пустой - если хода нет
+    TurnDelta        delta;   // перемещение, сбор линий и ход компьютера
+};
+
+/**
+ * Розыгрыш ходов игрока в собственном потоке: поиск пути, перемещение, сбор линий
+ * и ход компьютера выполняются на копии движка, которую поток получает вместе с ходом
+ * и больше ни с кем не делит. Итог возвращается одним набором изменений TurnDelta,
+ * который модель применяет к своему движку.
+ * Новый ход или cancel отменяют еще не начатый розыгрыш. Итог забирается после сигнала
+ * resolved по номеру запроса, по которому вызывающая сторона отбрасывает устаревшие
+ */
+class TurnWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TurnWorker(QObject *parent = 0);
+
+    void post(std::unique_ptr<LinesEngine> position, const Move& move, int request);
+    void cancel();
+    bool takeResult(int request, TurnResult& result);
+
+public slots:
+    void resolve();
+
+signals:
+    void resolved(int request);
+
+private:
+    UndoStack                    recorder;
+    QMutex                       mutex;
+    std::unique_ptr<LinesEngine> pending;
+    Move                         pendingMove;
+    int                          pendingRequest = 0;
+    TurnResult                   result;
+};
+
+#endif // TURNWORKER_H
@@ -0,0 +1,288 @@
+#ifndef BASICLINESENGINE_H
+#define BASICLINESENGINE_H
+
+#include "boardcore.h"
+#include "linesengine.h"
+#include "tracer.h"
+
+/**
+ * Реализация правил для поля с геометрией Geometry.
+ * Весь ход выполняется внутри шаблона, поэтому для FixedGeometry индексная арифметика
+ * и проверки соседей компилируются с константами
+ */
+template <class Geometry>
+class BasicLinesEngine : public LinesEngine {
+    static_assert(int(BoardCore<Geometry>::MAX_COLORS) == int(LinesEngine::MAX_COLORS),
+                  "engine and board color limits must agree");
+public:
+    typedef BoardCore<Geometry> Board;
+
+    explicit BasicLinesEngine(const LinesRules& rules, const Geometry& geometry = Geometry())
+        : LinesEngine(rules),
+          m_board(geometry) {
+    }
+
+    std::unique_ptr<LinesEngine> clone() const override {
+        return std::unique_ptr<LinesEngine>(new BasicLinesEngine(*this));
+    }
+
+    const Board& board() const {
+        return m_board;
+    }
+
+    int rows() const override {
+        return m_board.geometry().rows();
+    }
+
+    int columns() const override {
+        return m_board.geometry().columns();
+    }
+
+    int cells() const override {
+        return m_board.cells();
+    }
+
+    bool isBusy(int index) const override {
+        return m_board.isBusy(index);
+    }
+
+    int colorAt(int index) const override {
+        return m_board.colorAt(index);
+    }
+
+    int freeCount() const override {
+        return m_board.freeCount();
+    }
+
+    int freeCellAt(int n) const override {
+        return m_board.freeCellAt(n);
+    }
+
+    bool isFinal() const override {
+        return m_board.checkIsFinal();
+    }
+
+    uint64_t hash() const override {
+        return m_board.hash();
+    }
+
+    /**
+     * @brief BasicLinesEngine::reset
+     * Очищает поле без уведомления об изменении ячеек и обнуляет счет
+     */
+    void reset() override {
+        m_board.clearAll();
+        setScore(0);
+    }
+
+    /**
+     * @brief BasicLinesEngine::restoreCell
+     * Размещает фигуру без уведомления, при восстановлении сохраненной партии
+     */
+    void restoreCell(int index, int idColor) override {
+        m_board.placeCell(index, idColor);
+    }
+
+    /**
+     * @brief BasicLinesEngine::restoreFreeOrder
+     * Восстанавливает порядок свободных ячеек, чтобы ходы компьютера после восстановления
+     * совпали с исходной партией
+     */
+    bool restoreFreeOrder(const int* cells, int count) override {
+        return m_board.restoreFreeOrder(cells, count);
+    }
+
+    /**
+     * @brief BasicLinesEngine::canMove
+     * Проверяет, что в from стоит фигура, to свободна и между ними есть свободный путь
+     */
+    bool canMove(int from, int to) const override {
+        TRACE_SPAN("BasicLinesEngine::canMove");
+        return from != to && m_board.isBusy(from) && !m_board.isBusy(to) &&
+                m_board.canReach(from, to);
+    }
+
+    /**
+     * @brief BasicLinesEngine::moveCell
+     * Перемещает фигуру, если ход допустим
+     * * @return true - если ход совершен
+     */
+    bool moveCell(int from, int to) override {
+        if (!canMove(from, to))
+            return false;
+        moveFree(from, to);
+        return true;
+    }
+
+    /**
+     * @brief BasicLinesEngine::shortestPath
+     * Ищет кратчайший путь фигуры. Буфер path переиспользуется между вызовами
+     * * @param path - ячейки пути от from до to включительно, пустой - если пути нет
+     * * @return длина пути в ячейках
+     */
+    int shortestPath(int from, int to, std::vector<int>& path) const override {
+        TRACE_SPAN("BasicLinesEngine::shortestPath");
+        path.resize(m_board.cells());
+        int length = m_board.shortestPath(from, to, path.data());
+        path.resize(length);
+        return length;
+    }
+
+    /**
+     * @brief BasicLinesEngine::moveAlong
+     * Перемещает фигуру по найденному shortestPath пути. Путь проверяется пошагово,
+     * без повторного поиска
+     * * @return true - если ход совершен
+     */
+    bool moveAlong(const std::vector<int>& path) override {
+        if (path.size() < 2 || !m_board.isBusy(path.front()))
+            return false;
+        for (size_t i = 1; i < path.size(); ++i)
+            if (m_board.isBusy(path[i]) || !m_board.isAdjacent(path[i - 1], path[i]))
+                return false;
+        moveFree(path.front(), path.back());
+        return true;
+    }
+
+    /**
+     * @brief BasicLinesEngine::applyPlace
+     * Размещает фигуру при отмене снятия или повторе размещения
+     */
+    void applyPlace(int index, int idColor) override {
+        m_board.placeCell(index, idColor);
+        notifyCell(index);
+    }
+
+    void applyClear(int index) override {
+        m_board.clearCell(index);
+        notifyCell(index);
+    }
+
+    /**
+     * @brief BasicLinesEngine::revertPlace
+     * Отменяет размещение фигуры в свободную ячейку, возвращая ячейку на позицию freePos
+     * массива свободных
+     */
+    void revertPlace(int index, int freePos) override {
+        m_board.unplaceCell(index, freePos);
+        notifyCell(index);
+    }
+
+    /**
+     * @brief BasicLinesEngine::makeComputerMove
+     * Выполняет ход компьютера, размещая в случайные свободные ячейки
+     * по фигуре случайного цвета
+     */
+    void makeComputerMove() override {
+        TRACE_SPAN("BasicLinesEngine::makeComputerMove");
+        m_spawned.clear();
+        for (int i = 0; i < m_rules.spawnCount && !m_board.checkIsFinal(); ++i) {
+            int step = m_random.bounded(m_board.freeCount());
+            int idColor = m_random.bounded(m_rules.colorsCount) + 1;
+            int idCell = m_board.freeCellAt(step);
+            m_board.placeCell(idCell, idColor);
+            notifyCell(idCell);
+            notifyPlaced(idCell, idColor, step);
+            m_spawned.push_back(idCell);
+        }
+        for (int idCell : m_spawned)
+            checkAndApplyWinLines(idCell);
+    }
+
+    /**
+     * @brief BasicLinesEngine::checkAndApplyWinLines
+     * Убирает все линии длиной не меньше lengthWin, проходящие через index, и начисляет очки
+     * * @return количество собранных линий
+     */
+    int checkAndApplyWinLines(int index) override {
+        TRACE_SPAN("BasicLinesEngine::checkAndApplyWinLines");
+        LineRun lines[4];
+        int count = m_board.linesThrough(index, m_rules.lengthWin, lines);
+        if (count == 0)
+            return 0;
+        for (int i = 0; i < count; ++i) {
+            const LineRun& line = lines[i];
+            for (int k = 0, ind = line.start; k < line.length; ++k, ind += line.step) {
+                if (ind != index)
+                    clearCell(ind);
+            }
+        }
+        clearCell(index);
+        setScore(m_score + count * m_rules.pointsForWin);
+        return count;
+    }
+
+    /**
+     * @brief BasicLinesEngine::countLines
+     * Считает все одноцветные линии длиной не меньше minLength по всему полю, не изменяя его
+     * * @return количество линий
+     */
+    int countLines(int minLength) const override {
+        return m_board.scanLines(minLength);
+    }
+
+    /**
+     * @brief BasicLinesEngine::legalMoves
+     * Перечисляет все допустимые ходы: фигура и достижимая для нее свободная ячейка
+     */
+    void legalMoves(std::vector<Move>& moves) const override {
+        TRACE_SPAN("BasicLinesEngine::legalMoves");
+        moves.clear();
+        const int cellsCount = m_board.cells();
+        for (int from = 0; from < cellsCount; ++from) {
+            if (!m_board.isBusy(from))
+                continue;
+            int neighbours[4];
+            int count = m_board.freeNeighbours(from, neighbours);
+            if (count == 0)
+                continue;
+            for (int k = 0; k < m_board.freeCount(); ++k) {
+                int to = m_board.freeCellAt(k);
+                int label = m_board.componentAt(to);
+                for (int i = 0; i < count; ++i) {
+                    if (m_board.componentAt(neighbours[i]) == label) {
+                        Move move;
+                        move.from = from;
+                        move.to = to;
+                        moves.push_back(move);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief BasicLinesEngine::longestRunIfMoved
+     * * @return длина самой длинной одноцветной серии через move.to после хода, без изменения поля
+     */
+    int longestRunIfMoved(const Move& move) const override {
+        return m_board.longestRunIfMoved(move.from, move.to);
+    }
+
+private:
+    Board m_board;
+
+    void clearCell(int index) {
+        if (m_board.isBusy(index))
+            notifyCleared(index, m_board.colorAt(index));
+        m_board.clearCell(index);
+        notifyCell(index);
+    }
+
+    /**
+     * @brief BasicLinesEngine::moveFree
+     * Перемещает фигуру в свободную ячейку без проверки пути
+     */
+    void moveFree(int from, int to) {
+        int idColor = m_board.colorAt(from);
+        int freePos = m_board.freePositionOf(to);
+        m_board.moveCell(from, to);
+        notifyCell(from);
+        notifyCell(to);
+        notifyPlaced(to, idColor, freePos);
+        notifyCleared(from, idColor);
+    }
+};
+
+#endif // BASICLINESENGINE_H
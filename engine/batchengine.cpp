@@ -0,0 +1,402 @@
+#include "batchengine.h"
+
+#include "bitops.h"
+#include "splitmix64.h"
+#include "tracer.h"
+
+namespace {
+
+/**
+ * @brief shiftedUp
+ * * @return слово w плоскости, сдвинутой на shift ячеек к старшим индексам
+ */
+inline uint64_t shiftedUp(const uint64_t* plane, int w, int shift) {
+    const int q = shift >> 6;
+    const int r = shift & 63;
+    uint64_t high = w - q >= 0 ? plane[w - q] : 0;
+    if (r == 0)
+        return high;
+    uint64_t low = w - q - 1 >= 0 ? plane[w - q - 1] : 0;
+    return (high << r) | (low >> (64 - r));
+}
+
+/**
+ * @brief shiftedDown
+ * * @return слово w плоскости, сдвинутой на shift ячеек к младшим индексам
+ */
+inline uint64_t shiftedDown(const uint64_t* plane, int words, int w, int shift) {
+    const int q = shift >> 6;
+    const int r = shift & 63;
+    uint64_t low = w + q < words ? plane[w + q] : 0;
+    if (r == 0)
+        return low;
+    uint64_t high = w + q + 1 < words ? plane[w + q + 1] : 0;
+    return (low >> r) | (high << (64 - r));
+}
+
+int countBits(const uint64_t* plane, int words) {
+    int count = 0;
+    for (int w = 0; w < words; ++w)
+        count += BitOps::popCount(plane[w]);
+    return count;
+}
+
+/**
+ * @brief selectBit
+ * * @return индекс n-й (с нуля) установленной ячейки плоскости, n < countBits
+ */
+int selectBit(const uint64_t* plane, int words, int n) {
+    for (int w = 0; w < words; ++w) {
+        uint64_t word = plane[w];
+        int count = BitOps::popCount(word);
+        if (n >= count) {
+            n -= count;
+            continue;
+        }
+        for (; n > 0; --n)
+            word &= word - 1;
+        return w * 64 + BitOps::countTrailingZeros(word);
+    }
+    return -1;
+}
+
+inline bool testBit(const uint64_t* plane, int index) {
+    return (plane[index >> 6] >> (index & 63)) & 1;
+}
+
+} // namespace
+
+BatchEngine::BatchEngine(int boards, int rows, int columns, const LinesRules& rules)
+    : m_boards(boards < 1 ? 1 : boards),
+      m_rows(rows < 1 ? 1 : rows > LinesEngine::MAX_SIDE ? int(LinesEngine::MAX_SIDE) : rows),
+      m_columns(columns < 1 ? 1 : columns > LinesEngine::MAX_SIDE ? int(LinesEngine::MAX_SIDE) : columns),
+      m_cells(m_rows * m_columns),
+      m_words((m_cells + 63) / 64),
+      m_rules(rules) {
+    if (m_rules.colorsCount < 1)
+        m_rules.colorsCount = 1;
+    if (m_rules.colorsCount > LinesEngine::MAX_COLORS)
+        m_rules.colorsCount = LinesEngine::MAX_COLORS;
+    if (m_rules.spawnCount < 0)
+        m_rules.spawnCount = 0;
+
+    m_cellStates.assign(size_t(m_boards) * m_cells, 0);
+    m_busy.assign(size_t(m_boards) * m_words, 0);
+    m_free.resize(size_t(m_boards) * m_cells);
+    m_freePos.resize(size_t(m_boards) * m_cells);
+    m_spawned.assign(size_t(m_boards) * (m_rules.spawnCount + 1), 0);
+    m_freeCount.assign(m_boards, m_cells);
+    m_spawnedCount.assign(m_boards, 0);
+    m_score.assign(m_boards, 0);
+    m_random.assign(m_boards, 0);
+    m_policyRandom.assign(m_boards, 0);
+    m_moved.assign(m_boards, 0);
+    for (int board = 0; board < m_boards; ++board) {
+        uint16_t* freeCells = &m_free[size_t(board) * m_cells];
+        uint16_t* freePos = &m_freePos[size_t(board) * m_cells];
+        for (int i = 0; i < m_cells; ++i) {
+            freeCells[i] = static_cast<uint16_t>(i);
+            freePos[i] = static_cast<uint16_t>(i);
+        }
+    }
+
+    m_inside.assign(m_words, 0);
+    m_hasLeft.assign(m_words, 0);
+    m_hasRight.assign(m_words, 0);
+    for (int i = 0; i < m_cells; ++i) {
+        const uint64_t bit = uint64_t(1) << (i & 63);
+        const int column = i % m_columns;
+        m_inside[i >> 6] |= bit;
+        if (column > 0)
+            m_hasLeft[i >> 6] |= bit;
+        if (column + 1 < m_columns)
+            m_hasRight[i >> 6] |= bit;
+    }
+    m_reach.assign(m_words, 0);
+    m_grown.assign(m_words, 0);
+    m_freePlane.assign(m_words, 0);
+}
+
+/**
+ * @brief BatchEngine::newGame
+ * Начинает партию на поле board так же, как LinesEngine::newGame:
+ * пустое поле, нулевой счет, генератор с состоянием seed и первый ход компьютера
+ */
+void BatchEngine::newGame(int board, uint64_t seed) {
+    uint8_t* states = &m_cellStates[size_t(board) * m_cells];
+    uint16_t* freeCells = &m_free[size_t(board) * m_cells];
+    uint16_t* freePos = &m_freePos[size_t(board) * m_cells];
+    for (int i = 0; i < m_cells; ++i) {
+        states[i] = 0;
+        freeCells[i] = static_cast<uint16_t>(i);
+        freePos[i] = static_cast<uint16_t>(i);
+    }
+    for (int w = 0; w < m_words; ++w)
+        m_busy[size_t(board) * m_words + w] = 0;
+    m_freeCount[board] = m_cells;
+    m_score[board] = 0;
+    m_random[board] = seed;
+
+    m_spawnedCount[board] = 0;
+    for (int i = 0; i < m_rules.spawnCount; ++i)
+        spawnPiece(board);
+    for (int i = 0; i < m_spawnedCount[board]; ++i)
+        clearLinesThrough(board, m_spawned[size_t(board) * (m_rules.spawnCount + 1) + i]);
+}
+
+/**
+ * @brief BatchEngine::seedPolicy
+ * Задает состояние генератора, которым chooseRandomMoves выбирает ходы поля board
+ */
+void BatchEngine::seedPolicy(int board, uint64_t seed) {
+    m_policyRandom[board] = seed;
+}
+
+/**
+ * @brief BatchEngine::canMove
+ * Проверяет, что в from стоит фигура, to свободна и между ними есть свободный путь
+ */
+bool BatchEngine::canMove(int board, int from, int to) const {
+    if (from < 0 || to < 0 || from >= m_cells || to >= m_cells || from == to)
+        return false;
+    if (!isBusy(board, from) || isBusy(board, to))
+        return false;
+    return flood(board, from, to);
+}
+
+/**
+ * @brief BatchEngine::chooseRandomMoves
+ * Выбирает для каждого поля случайный допустимый ход: случайную фигуру со свободным соседом
+ * и случайную достижимую для нее свободную ячейку. Ищется заливкой плоскостей, без перебора ходов
+ * * @param moves - boards() ходов; Move() - у поля нет допустимого хода
+ */
+void BatchEngine::chooseRandomMoves(Move* moves) {
+    TRACE_SPAN("BatchEngine::chooseRandomMoves");
+    for (int board = 0; board < m_boards; ++board) {
+        moves[board] = Move();
+        if (isFinal(board))
+            continue;
+        loadFreePlane(board);
+        neighbours(m_freePlane.data(), m_grown.data());
+        const uint64_t* busy = &m_busy[size_t(board) * m_words];
+        for (int w = 0; w < m_words; ++w)
+            m_grown[w] &= busy[w];
+        int movable = countBits(m_grown.data(), m_words);
+        if (movable == 0)
+            continue;
+        SplitMix64 random(m_policyRandom[board]);
+        int from = selectBit(m_grown.data(), m_words, random.bounded(movable));
+        flood(board, from, -1);
+        int to = selectBit(m_reach.data(), m_words, random.bounded(countBits(m_reach.data(), m_words)));
+        m_policyRandom[board] = random.state();
+        moves[board].from = from;
+        moves[board].to = to;
+    }
+}
+
+/**
+ * @brief BatchEngine::playTurns
+ * Полный ход на всех полях сразу, по стадиям: перемещения, линии через целевые ячейки,
+ * размещение фигур компьютера и линии через них. Для каждого поля порядок действий
+ * тот же, что у LinesEngine::playTurn
+ * * @param moves - boards() ходов; поле с недопустимым ходом или законченной партией пропускается
+ * * @return количество полей, на которых ход сделан
+ */
+int BatchEngine::playTurns(const Move* moves) {
+    TRACE_SPAN("BatchEngine::playTurns");
+    int played = 0;
+    for (int board = 0; board < m_boards; ++board) {
+        const Move& move = moves[board];
+        m_moved[board] = !isFinal(board) && canMove(board, move.from, move.to);
+        if (!m_moved[board])
+            continue;
+        moveCell(board, move.from, move.to);
+        ++played;
+    }
+    for (int board = 0; board < m_boards; ++board)
+        if (m_moved[board])
+            clearLinesThrough(board, moves[board].to);
+
+    for (int board = 0; board < m_boards; ++board)
+        m_spawnedCount[board] = 0;
+    for (int i = 0; i < m_rules.spawnCount; ++i)
+        for (int board = 0; board < m_boards; ++board)
+            if (m_moved[board])
+                spawnPiece(board);
+    for (int i = 0; i < m_rules.spawnCount; ++i)
+        for (int board = 0; board < m_boards; ++board)
+            if (m_moved[board] && i < m_spawnedCount[board])
+                clearLinesThrough(board, m_spawned[size_t(board) * (m_rules.spawnCount + 1) + i]);
+    return played;
+}
+
+/**
+ * @brief BatchEngine::placeCell
+ * Размещает фигуру; свободная ячейка убирается из плотного массива перестановкой с последней
+ */
+void BatchEngine::placeCell(int board, int index, int idColor) {
+    uint8_t& state = m_cellStates[size_t(board) * m_cells + index];
+    if (!(state & BUSY)) {
+        uint16_t* freeCells = &m_free[size_t(board) * m_cells];
+        uint16_t* freePos = &m_freePos[size_t(board) * m_cells];
+        int pos = freePos[index];
+        int last = freeCells[--m_freeCount[board]];
+        freeCells[pos] = static_cast<uint16_t>(last);
+        freePos[last] = static_cast<uint16_t>(pos);
+    }
+    state = static_cast<uint8_t>(idColor | BUSY);
+    m_busy[size_t(board) * m_words + (index >> 6)] |= uint64_t(1) << (index & 63);
+}
+
+/**
+ * @brief BatchEngine::clearCell
+ * Освобождает ячейку, сохраняя ее последний цвет, и дописывает ее в конец массива свободных
+ */
+void BatchEngine::clearCell(int board, int index) {
+    uint8_t& state = m_cellStates[size_t(board) * m_cells + index];
+    if (!(state & BUSY))
+        return;
+    int count = m_freeCount[board]++;
+    m_free[size_t(board) * m_cells + count] = static_cast<uint16_t>(index);
+    m_freePos[size_t(board) * m_cells + index] = static_cast<uint16_t>(count);
+    state = static_cast<uint8_t>(state & COLOR_MASK);
+    m_busy[size_t(board) * m_words + (index >> 6)] &= ~(uint64_t(1) << (index & 63));
+}
+
+void BatchEngine::moveCell(int board, int from, int to) {
+    placeCell(board, to, colorAt(board, from));
+    clearCell(board, from);
+}
+
+/**
+ * @brief BatchEngine::spawnPiece
+ * Размещает одну фигуру компьютера: те же два числа генератора, что у
+ * BasicLinesEngine::makeComputerMove, - позиция в массиве свободных и цвет
+ * * @return false - если свободных ячеек нет
+ */
+bool BatchEngine::spawnPiece(int board) {
+    if (isFinal(board))
+        return false;
+    SplitMix64 random(m_random[board]);
+    int step = random.bounded(m_freeCount[board]);
+    int idColor = random.bounded(m_rules.colorsCount) + 1;
+    m_random[board] = random.state();
+    int idCell = freeCellAt(board, step);
+    placeCell(board, idCell, idColor);
+    m_spawned[size_t(board) * (m_rules.spawnCount + 1) + m_spawnedCount[board]++] = idCell;
+    return true;
+}
+
+/**
+ * @brief BatchEngine::clearLinesThrough
+ * Убирает все линии длиной не меньше lengthWin через фигуру в index и начисляет очки.
+ * Направления и порядок снятия ячеек - как у LineIndex::linesThrough и
+ * BasicLinesEngine::checkAndApplyWinLines, от него зависит порядок массива свободных
+ * * @return количество собранных линий
+ */
+int BatchEngine::clearLinesThrough(int board, int index) {
+    if (!isBusy(board, index) || colorAt(board, index) == 0)
+        return 0;
+    static const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    int firsts[4];
+    int steps[4];
+    int lengths[4];
+    int count = 0;
+    for (int d = 0; d < 4; ++d) {
+        int first;
+        int length = runAround(board, index, directions[d][0], directions[d][1], first);
+        if (length < m_rules.lengthWin)
+            continue;
+        firsts[count] = first;
+        steps[count] = directions[d][0] * m_columns + directions[d][1];
+        lengths[count] = length;
+        ++count;
+    }
+    if (count == 0)
+        return 0;
+    for (int i = 0; i < count; ++i)
+        for (int k = 0, ind = firsts[i]; k < lengths[i]; ++k, ind += steps[i])
+            if (ind != index)
+                clearCell(board, ind);
+    clearCell(board, index);
+    m_score[board] += count * m_rules.pointsForWin;
+    return count;
+}
+
+/**
+ * @brief BatchEngine::runAround
+ * Серия фигур цвета index вдоль направления (rowStep, columnStep) через index
+ * * @param first - первая ячейка серии по направлению
+ * * @return длина серии
+ */
+int BatchEngine::runAround(int board, int index, int rowStep, int columnStep, int& first) const {
+    const uint8_t* states = &m_cellStates[size_t(board) * m_cells];
+    const uint8_t state = states[index];
+    int row = index / m_columns;
+    int column = index % m_columns;
+    int r = row;
+    int c = column;
+    while (r - rowStep >= 0 && c - columnStep >= 0 && c - columnStep < m_columns &&
+           states[(r - rowStep) * m_columns + c - columnStep] == state) {
+        r -= rowStep;
+        c -= columnStep;
+    }
+    first = r * m_columns + c;
+    int length = 1;
+    while (r + rowStep < m_rows && c + columnStep >= 0 && c + columnStep < m_columns &&
+           states[(r + rowStep) * m_columns + c + columnStep] == state) {
+        r += rowStep;
+        c += columnStep;
+        ++length;
+    }
+    return length;
+}
+
+void BatchEngine::loadFreePlane(int board) const {
+    const uint64_t* busy = &m_busy[size_t(board) * m_words];
+    for (int w = 0; w < m_words; ++w)
+        m_freePlane[w] = ~busy[w] & m_inside[w];
+}
+
+/**
+ * @brief BatchEngine::neighbours
+ * * @param out - ячейки поля, соседние по горизонтали или вертикали с ячейками plane
+ */
+void BatchEngine::neighbours(const uint64_t* plane, uint64_t* out) const {
+    for (int w = 0; w < m_words; ++w)
+        out[w] = ((shiftedUp(plane, w, 1) & m_hasLeft[w]) |
+                  (shiftedDown(plane, m_words, w, 1) & m_hasRight[w]) |
+                  shiftedUp(plane, w, m_columns) |
+                  shiftedDown(plane, m_words, w, m_columns)) & m_inside[w];
+}
+
+/**
+ * @brief BatchEngine::flood
+ * Заливает в m_reach свободные ячейки, достижимые из фигуры в from
+ * * @param target - ячейка, при достижении которой заливка прекращается; -1 - залить все
+ * * @return true, если target достижима
+ */
+bool BatchEngine::flood(int board, int from, int target) const {
+    loadFreePlane(board);
+    for (int w = 0; w < m_words; ++w)
+        m_grown[w] = 0;
+    m_grown[from >> 6] = uint64_t(1) << (from & 63);
+    neighbours(m_grown.data(), m_reach.data());
+    bool isChanged = false;
+    for (int w = 0; w < m_words; ++w) {
+        m_reach[w] &= m_freePlane[w];
+        isChanged |= m_reach[w] != 0;
+    }
+    while (isChanged) {
+        if (target >= 0 && testBit(m_reach.data(), target))
+            return true;
+        neighbours(m_reach.data(), m_grown.data());
+        isChanged = false;
+        for (int w = 0; w < m_words; ++w) {
+            uint64_t grown = (m_grown[w] & m_freePlane[w]) | m_reach[w];
+            isChanged |= grown != m_reach[w];
+            m_reach[w] = grown;
+        }
+    }
+    return target >= 0 && testBit(m_reach.data(), target);
+}
@@ -0,0 +1,132 @@
+#ifndef BATCHENGINE_H
+#define BATCHENGINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "linesengine.h"
+
+/**
+ * Пакет из boards() партий на полях одного размера, которые продвигаются одновременно:
+ * каждая стадия хода (перемещение, сбор линий, ход компьютера) проходит циклом по всему
+ * пакету, без виртуальных вызовов и уведомлений.
+ * Состояние хранится массивами по полям (struct of arrays): ячейки, плоскости занятости,
+ * плотные массивы свободных ячеек, счет и генераторы - каждое в своем непрерывном массиве,
+ * данные одного поля в нем лежат подряд.
+ * Правила совпадают с BasicLinesEngine до порядка массива свободных ячеек и состояния
+ * генератора, поэтому партия с тем же зерном и ходами дает ту же позицию
+ */
+class BatchEngine {
+public:
+    BatchEngine(int boards, int rows = LinesEngine::DEFAULT_ROWS, int columns = LinesEngine::DEFAULT_COLUMNS,
+                const LinesRules& rules = LinesRules());
+
+    int boards() const {
+        return m_boards;
+    }
+
+    int rows() const {
+        return m_rows;
+    }
+
+    int columns() const {
+        return m_columns;
+    }
+
+    int cells() const {
+        return m_cells;
+    }
+
+    const LinesRules& rules() const {
+        return m_rules;
+    }
+
+    bool isBusy(int board, int index) const {
+        return (m_cellStates[board * m_cells + index] & BUSY) != 0;
+    }
+
+    /**
+     * @brief BatchEngine::colorAt
+     * * @return id цвета ячейки; освобожденная ячейка сохраняет последний цвет, как в BoardCore
+     */
+    int colorAt(int board, int index) const {
+        return m_cellStates[board * m_cells + index] & COLOR_MASK;
+    }
+
+    int freeCount(int board) const {
+        return m_freeCount[board];
+    }
+
+    int freeCellAt(int board, int n) const {
+        return m_free[board * m_cells + n];
+    }
+
+    bool isFinal(int board) const {
+        return m_freeCount[board] <= 0;
+    }
+
+    int score(int board) const {
+        return m_score[board];
+    }
+
+    uint64_t randomState(int board) const {
+        return m_random[board];
+    }
+
+    void newGame(int board, uint64_t seed);
+    void seedPolicy(int board, uint64_t seed);
+
+    bool canMove(int board, int from, int to) const;
+    void chooseRandomMoves(Move* moves);
+    int  playTurns(const Move* moves);
+
+private:
+    enum {
+        BUSY       = 0x80,
+        COLOR_MASK = 0x7F
+    };
+
+    int        m_boards;
+    int        m_rows;
+    int        m_columns;
+    int        m_cells;
+    int        m_words;
+    LinesRules m_rules;
+
+    // по полю подряд: cells() ячеек, m_words слов плоскости, spawnCount появившихся фигур
+    std::vector<uint8_t>  m_cellStates;
+    std::vector<uint64_t> m_busy;
+    std::vector<uint16_t> m_free;
+    std::vector<uint16_t> m_freePos;
+    std::vector<int>      m_spawned;
+
+    std::vector<int>      m_freeCount;
+    std::vector<int>      m_spawnedCount;
+    std::vector<int>      m_score;
+    std::vector<uint64_t> m_random;
+    std::vector<uint64_t> m_policyRandom;
+    std::vector<uint8_t>  m_moved;
+
+    // маски поля по словам: ячейки внутри поля и ячейки, у которых есть сосед слева и справа
+    std::vector<uint64_t> m_inside;
+    std::vector<uint64_t> m_hasLeft;
+    std::vector<uint64_t> m_hasRight;
+
+    // рабочие плоскости заливки, общие для всех полей
+    mutable std::vector<uint64_t> m_reach;
+    mutable std::vector<uint64_t> m_grown;
+    mutable std::vector<uint64_t> m_freePlane;
+
+    void placeCell(int board, int index, int idColor);
+    void clearCell(int board, int index);
+    void moveCell(int board, int from, int to);
+    bool spawnPiece(int board);
+    int  clearLinesThrough(int board, int index);
+    int  runAround(int board, int index, int rowStep, int columnStep, int& first) const;
+
+    void loadFreePlane(int board) const;
+    void neighbours(const uint64_t* plane, uint64_t* out) const;
+    bool flood(int board, int from, int target) const;
+};
+
+#endif // BATCHENGINE_H
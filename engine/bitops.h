@@ -0,0 +1,57 @@
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Переносимые битовые операции над 64-битными словами
+ */
+namespace BitOps {
+
+inline int popCount(uint64_t word) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+/**
+ * @brief countTrailingZeros
+ * * @return количество младших нулевых бит, 64 для нулевого слова
+ */
+inline int countTrailingZeros(uint64_t word) {
+    if (word == 0)
+        return 64;
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+/**
+ * @brief countLeadingZeros
+ * * @return количество старших нулевых бит, 64 для нулевого слова
+ */
+inline int countLeadingZeros(uint64_t word) {
+    if (word == 0)
+        return 64;
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(word);
+#endif
+}
+
+} // namespace BitOps
+
+#endif // BITOPS_H
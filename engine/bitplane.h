@@ -0,0 +1,53 @@
+#ifndef BITPLANE_H
+#define BITPLANE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bitops.h"
+
+/**
+ * Битовая плоскость фиксированной ширины: по одному биту на ячейку поля
+ */
+template <size_t Bits>
+class BitPlane {
+public:
+    enum { WORDS = (Bits + 63) / 64 };
+
+    bool test(int index) const {
+        return (m_words[index >> 6] >> (index & 63)) & 1u;
+    }
+
+    void set(int index) {
+        m_words[index >> 6] |= uint64_t(1) << (index & 63);
+    }
+
+    void reset(int index) {
+        m_words[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    }
+
+    void clear() {
+        for (size_t i = 0; i < WORDS; ++i)
+            m_words[i] = 0;
+    }
+
+    int count() const {
+        int res = 0;
+        for (size_t i = 0; i < WORDS; ++i)
+            res += BitOps::popCount(m_words[i]);
+        return res;
+    }
+
+    uint64_t word(size_t i) const {
+        return m_words[i];
+    }
+
+    void setWord(size_t i, uint64_t word) {
+        m_words[i] = word;
+    }
+
+private:
+    uint64_t m_words[WORDS] = {};
+};
+
+#endif // BITPLANE_H
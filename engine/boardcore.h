@@ -0,0 +1,444 @@
+#ifndef BOARDCORE_H
+#define BOARDCORE_H
+
+#include <cstdint>
+
+#include "bitplane.h"
+#include "boardgeometry.h"
+#include "lineindex.h"
+#include "linescan.h"
+#include "splitmix64.h"
+
+/**
+ * Компактное ядро игрового поля: плоскость занятости и по одной плоскости на каждый цвет
+ * (не больше MAX_COLORS - цвет вместе с признаком занятости укладывается в 4 бита сохранения).
+ * Освобожденная ячейка сохраняет последний цвет, чтобы представление могло анимировать исчезновение.
+ * Связные области свободных ячеек размечаются лениво, один раз после каждого изменения поля,
+ * а индекс линий обновляется на месте при каждом размещении и снятии фигуры.
+ * Свободные ячейки хранятся плотным массивом с картой позиций: выбор, добавление
+ * и удаление (перестановкой с последним) выполняются за постоянное время.
+ * Размер поля задает Geometry: FixedGeometry для размеров, известных при компиляции,
+ * либо DynamicGeometry для произвольного прямоугольника.
+ * Хеш Зобриста занятых ячеек с их цветами обновляется при каждом размещении и снятии фигуры.
+ */
+template <class Geometry>
+class BoardCore {
+    static_assert(Geometry::MAX_CELLS < 65536, "cell positions are 16-bit");
+public:
+    enum {
+        MAX_CELLS  = Geometry::MAX_CELLS,
+        MAX_COLORS = 7
+    };
+
+    bool isBusy(int index) const {
+        return m_busy.test(index);
+    }
+
+    /**
+     * @brief BoardCore::colorAt
+     * * @return id цвета ячейки (0 - бесцветная)
+     */
+    int colorAt(int index) const {
+        for (int i = 0; i < MAX_COLORS; ++i)
+            if (m_colors[i].test(index))
+                return i + 1;
+        return 0;
+    }
+
+    bool hasColor(int index, int idColor) const {
+        return idColor > 0 && m_colors[idColor - 1].test(index);
+    }
+
+    explicit BoardCore(const Geometry& geometry = Geometry())
+        : m_geometry(geometry),
+          m_lines(geometry) {
+        clearAll();
+    }
+
+    const Geometry& geometry() const {
+        return m_geometry;
+    }
+
+    int cells() const {
+        return m_geometry.cells();
+    }
+
+    /**
+     * @brief BoardCore::hash
+     * * @return хеш Зобриста позиции: одинаков для одинаковых расстановок фигур
+     * независимо от порядка ходов
+     */
+    uint64_t hash() const {
+        return m_hash;
+    }
+
+    /**
+     * @brief BoardCore::zobristKey
+     * Ключ пары (ячейка, цвет). Ключи не хранятся таблицей, а вычисляются
+     * перемешиванием номера пары, поэтому одинаковы во всех полях и потоках
+     */
+    static uint64_t zobristKey(int index, int idColor) {
+        return SplitMix64::mix((uint64_t(index) * (MAX_COLORS + 1) + uint64_t(idColor) + 1) *
+                               0x9E3779B97F4A7C15ull);
+    }
+
+    /**
+     * @brief BoardCore::placeCell
+     * Размещает фигуру цвета idColor в ячейке index
+     */
+    void placeCell(int index, int idColor) {
+        if (m_busy.test(index)) {
+            int oldColor = colorAt(index);
+            m_lines.remove(index, oldColor);
+            m_hash ^= zobristKey(index, oldColor);
+        } else {
+            removeFree(index);
+        }
+        resetColor(index);
+        m_hash ^= zobristKey(index, idColor);
+        if (idColor > 0) {
+            m_colors[idColor - 1].set(index);
+            m_lines.place(index, idColor);
+        }
+        m_busy.set(index);
+        m_labelsDirty = true;
+    }
+
+    /**
+     * @brief BoardCore::clearCell
+     * Освобождает ячейку, сохраняя ее последний цвет
+     */
+    void clearCell(int index) {
+        if (m_busy.test(index)) {
+            int oldColor = colorAt(index);
+            m_lines.remove(index, oldColor);
+            m_hash ^= zobristKey(index, oldColor);
+            addFree(index);
+        }
+        m_busy.reset(index);
+        m_labelsDirty = true;
+    }
+
+    /**
+     * @brief BoardCore::unplaceCell
+     * Обращает placeCell в свободную ячейку: освобождает ячейку и возвращает ее на прежнюю
+     * позицию freePos массива свободных. Если изменения обращаются в обратном порядке,
+     * массив свободных восстанавливается в точности
+     */
+    void unplaceCell(int index, int freePos) {
+        clearCell(index);
+        int last = m_freeCount - 1;
+        if (freePos < 0 || freePos >= last || m_free[last] != index)
+            return;
+        int other = m_free[freePos];
+        m_free[freePos] = static_cast<uint16_t>(index);
+        m_freePos[index] = static_cast<uint16_t>(freePos);
+        m_free[last] = static_cast<uint16_t>(other);
+        m_freePos[other] = static_cast<uint16_t>(last);
+    }
+
+    /**
+     * @brief BoardCore::moveCell
+     * Перемещает фигуру из indexFrom в indexTo
+     */
+    void moveCell(int indexFrom, int indexTo) {
+        placeCell(indexTo, colorAt(indexFrom));
+        clearCell(indexFrom);
+    }
+
+    /**
+     * @brief BoardCore::clearAll
+     * Делает все ячейки свободными и бесцветными
+     */
+    void clearAll() {
+        m_busy.clear();
+        for (int i = 0; i < MAX_COLORS; ++i)
+            m_colors[i].clear();
+        m_lines.clear();
+        const int cellsCount = m_geometry.cells();
+        for (int i = 0; i < cellsCount; ++i) {
+            m_free[i] = static_cast<uint16_t>(i);
+            m_freePos[i] = static_cast<uint16_t>(i);
+        }
+        m_freeCount = cellsCount;
+        m_hash = 0;
+        m_labelsDirty = true;
+    }
+
+    int freeCount() const {
+        return m_freeCount;
+    }
+
+    /**
+     * @brief BoardCore::freeCellAt
+     * * @return индекс n-й (с нуля) свободной ячейки плотного массива, n < freeCount()
+     */
+    int freeCellAt(int n) const {
+        return m_free[n];
+    }
+
+    /**
+     * @brief BoardCore::freePositionOf
+     * * @return позиция свободной ячейки index в массиве свободных
+     */
+    int freePositionOf(int index) const {
+        return m_freePos[index];
+    }
+
+    /**
+     * @brief BoardCore::restoreFreeOrder
+     * Восстанавливает порядок плотного массива свободных ячеек, от которого зависит
+     * выбор ячеек ходом компьютера
+     * * @param cells - перестановка текущих свободных ячеек
+     * * @return false - если cells не совпадает с множеством свободных ячеек
+     */
+    bool restoreFreeOrder(const int* cells, int count) {
+        if (count != m_freeCount)
+            return false;
+        BitPlane<MAX_CELLS> seen;
+        for (int i = 0; i < count; ++i) {
+            int index = cells[i];
+            if (index < 0 || index >= m_geometry.cells() || m_busy.test(index) || seen.test(index))
+                return false;
+            seen.set(index);
+        }
+        for (int i = 0; i < count; ++i) {
+            m_free[i] = static_cast<uint16_t>(cells[i]);
+            m_freePos[cells[i]] = static_cast<uint16_t>(i);
+        }
+        return true;
+    }
+
+    bool checkIsFinal() const {
+        return m_freeCount <= 0;
+    }
+
+    /**
+     * @brief BoardCore::linesThrough
+     * Находит все одноцветные линии длиной не меньше minLength, проходящие через фигуру в index,
+     * по горизонтали, вертикали и обеим диагоналям
+     * * @return количество найденных линий, 0 для свободной ячейки
+     */
+    int linesThrough(int index, int minLength, LineRun out[4]) const {
+        int idColor = colorAt(index);
+        if (!m_busy.test(index) || idColor == 0)
+            return 0;
+        return m_lines.linesThrough(index, idColor, minLength, out);
+    }
+
+    /**
+     * @brief BoardCore::scanLines
+     * Находит разом все одноцветные линии длиной не меньше minLength по всему полю:
+     * плоскости занятых ячеек каждого цвета переставляются по словам и проходятся LineScan
+     * * @param lineCells - если не nullptr, получает ячейки, входящие в линии
+     * * @return количество линий
+     */
+    int scanLines(int minLength, BitPlane<MAX_CELLS>* lineCells = nullptr) const {
+        static_assert(int(MAX_COLORS) <= int(LineScan::LANES), "one scan lane per color");
+        static_assert(int(BitPlane<MAX_CELLS>::WORDS) <= int(LineScan::MAX_WORDS), "board exceeds scan size");
+        const int rows = m_geometry.rows();
+        const int columns = m_geometry.columns();
+        const int words = LineScan::words(rows, columns);
+        if (words <= 0)
+            return 0;
+        uint64_t planes[BitPlane<MAX_CELLS>::WORDS][LineScan::LANES];
+        for (int w = 0; w < words; ++w) {
+            const uint64_t busy = m_busy.word(w);
+            for (int c = 0; c < MAX_COLORS; ++c)
+                planes[w][c] = m_colors[c].word(w) & busy;
+            for (int c = MAX_COLORS; c < LineScan::LANES; ++c)
+                planes[w][c] = 0;
+        }
+        if (!lineCells)
+            return LineScan::scan(&planes[0][0], rows, columns, minLength);
+        uint64_t cells[BitPlane<MAX_CELLS>::WORDS];
+        int count = LineScan::scan(&planes[0][0], rows, columns, minLength, cells);
+        lineCells->clear();
+        for (int w = 0; w < words; ++w)
+            lineCells->setWord(w, cells[w]);
+        return count;
+    }
+
+    /**
+     * @brief BoardCore::longestRunIfMoved
+     * * @return длина самой длинной серии через to после переноса фигуры из from в to
+     */
+    int longestRunIfMoved(int from, int to) const {
+        int idColor = colorAt(from);
+        if (!m_busy.test(from) || idColor == 0)
+            return 0;
+        return m_lines.longestRunIfMoved(from, to, idColor);
+    }
+
+    /**
+     * @brief BoardCore::componentAt
+     * * @return метка связной области свободных ячеек, либо 0 для занятой ячейки
+     */
+    int componentAt(int index) const {
+        if (m_labelsDirty)
+            labelComponents();
+        return m_labels[index];
+    }
+
+    /**
+     * @brief BoardCore::canReach
+     * Определяет, существует ли свободный путь от фигуры в from до свободной ячейки to
+     * * @return true, если to лежит в одной связной области с одним из свободных соседей from
+     */
+    bool canReach(int from, int to) const {
+        if (from == to)
+            return true;
+        if (m_busy.test(to))
+            return false;
+        int label = componentAt(to);
+        int neighbours[4];
+        int count = freeNeighbours(from, neighbours);
+        for (int i = 0; i < count; ++i)
+            if (m_labels[neighbours[i]] == label)
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief BoardCore::shortestPath
+     * Ищет кратчайший путь фигуры из from в свободную ячейку to обходом в ширину
+     * по заранее выделенным буферам поля
+     * * @param out - ячейки пути от from до to включительно, не меньше cells() элементов
+     * * @return длина пути в ячейках, 0 - если пути нет
+     */
+    int shortestPath(int from, int to, int* out) const {
+        if (from == to || !m_busy.test(from) || m_busy.test(to))
+            return 0;
+        const int cellsCount = m_geometry.cells();
+        for (int i = 0; i < cellsCount; ++i)
+            m_parent[i] = NO_PARENT;
+        int head = 0;
+        int tail = 0;
+        m_parent[from] = static_cast<uint16_t>(from);
+        m_queue[tail++] = static_cast<uint16_t>(from);
+        while (head < tail && m_parent[to] == NO_PARENT) {
+            int index = m_queue[head++];
+            int neighbours[4];
+            int count = freeNeighbours(index, neighbours);
+            for (int i = 0; i < count; ++i) {
+                if (m_parent[neighbours[i]] == NO_PARENT) {
+                    m_parent[neighbours[i]] = static_cast<uint16_t>(index);
+                    m_queue[tail++] = static_cast<uint16_t>(neighbours[i]);
+                }
+            }
+        }
+        if (m_parent[to] == NO_PARENT)
+            return 0;
+        int length = 1;
+        for (int index = to; index != from; index = m_parent[index])
+            ++length;
+        int position = length;
+        for (int index = to; ; index = m_parent[index]) {
+            out[--position] = index;
+            if (index == from)
+                break;
+        }
+        return length;
+    }
+
+    /**
+     * @brief BoardCore::isAdjacent
+     * * @return true, если ячейки соседние по горизонтали или вертикали
+     */
+    bool isAdjacent(int first, int second) const {
+        int rowDistance = m_geometry.rowOf(first) - m_geometry.rowOf(second);
+        int columnDistance = m_geometry.columnOf(first) - m_geometry.columnOf(second);
+        return rowDistance * rowDistance + columnDistance * columnDistance == 1;
+    }
+
+    /**
+     * @brief BoardCore::freeNeighbours
+     * Записывает в out индексы свободных клеток справа, слева, вверху и внизу от index
+     * * @return количество найденных соседей (не больше 4)
+     */
+    int freeNeighbours(int index, int out[4]) const {
+        const int columns = m_geometry.columns();
+        int count = 0;
+        int column = m_geometry.columnOf(index);
+        if (column + 1 < columns && !m_busy.test(index + 1))
+            out[count++] = index + 1;
+        if (column > 0 && !m_busy.test(index - 1))
+            out[count++] = index - 1;
+        if (index >= columns && !m_busy.test(index - columns))
+            out[count++] = index - columns;
+        if (index + columns < m_geometry.cells() && !m_busy.test(index + columns))
+            out[count++] = index + columns;
+        return count;
+    }
+
+private:
+    enum {
+        NO_PARENT = 0xFFFF
+    };
+
+    Geometry            m_geometry;
+    BitPlane<MAX_CELLS> m_busy;
+    BitPlane<MAX_CELLS> m_colors[MAX_COLORS];
+
+    uint16_t m_free[MAX_CELLS];
+    uint16_t m_freePos[MAX_CELLS];
+    int      m_freeCount {0};
+    uint64_t m_hash      {0};
+
+    LineIndex<Geometry, MAX_COLORS> m_lines;
+
+    mutable uint16_t m_labels[MAX_CELLS];
+    mutable uint16_t m_queue[MAX_CELLS];
+    mutable uint16_t m_parent[MAX_CELLS];
+    mutable bool     m_labelsDirty {true};
+
+    /**
+     * @brief BoardCore::labelComponents
+     * Размечает связные области свободных ячеек обходом в ширину по фиксированной очереди
+     */
+    void labelComponents() const {
+        const int cellsCount = m_geometry.cells();
+        for (int i = 0; i < cellsCount; ++i)
+            m_labels[i] = 0;
+        uint16_t label = 0;
+        for (int start = 0; start < cellsCount; ++start) {
+            if (m_busy.test(start) || m_labels[start] != 0)
+                continue;
+            ++label;
+            int head = 0;
+            int tail = 0;
+            m_labels[start] = label;
+            m_queue[tail++] = static_cast<uint16_t>(start);
+            while (head < tail) {
+                int neighbours[4];
+                int count = freeNeighbours(m_queue[head++], neighbours);
+                for (int i = 0; i < count; ++i) {
+                    if (m_labels[neighbours[i]] == 0) {
+                        m_labels[neighbours[i]] = label;
+                        m_queue[tail++] = static_cast<uint16_t>(neighbours[i]);
+                    }
+                }
+            }
+        }
+        m_labelsDirty = false;
+    }
+
+    void addFree(int index) {
+        m_freePos[index] = static_cast<uint16_t>(m_freeCount);
+        m_free[m_freeCount++] = static_cast<uint16_t>(index);
+    }
+
+    void removeFree(int index) {
+        int pos = m_freePos[index];
+        int last = m_free[--m_freeCount];
+        m_free[pos] = static_cast<uint16_t>(last);
+        m_freePos[last] = static_cast<uint16_t>(pos);
+    }
+
+    void resetColor(int index) {
+        for (int i = 0; i < MAX_COLORS; ++i)
+            m_colors[i].reset(index);
+    }
+};
+
+#endif // BOARDCORE_H
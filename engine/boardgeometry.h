@@ -0,0 +1,91 @@
+#ifndef BOARDGEOMETRY_H
+#define BOARDGEOMETRY_H
+
+/**
+ * Размер поля, известный при компиляции: деление индекса на ширину
+ * и проверки границ соседей сводятся к константам
+ */
+template <int Rows, int Columns>
+class FixedGeometry {
+public:
+    enum {
+        MAX_ROWS    = Rows,
+        MAX_COLUMNS = Columns,
+        MAX_CELLS   = Rows * Columns
+    };
+
+    FixedGeometry() {
+    }
+
+    FixedGeometry(int, int) {
+    }
+
+    int rows() const {
+        return Rows;
+    }
+
+    int columns() const {
+        return Columns;
+    }
+
+    int cells() const {
+        return Rows * Columns;
+    }
+
+    int rowOf(int index) const {
+        return index / Columns;
+    }
+
+    int columnOf(int index) const {
+        return index % Columns;
+    }
+};
+
+/**
+ * Размер поля, задаваемый при создании, не больше MaxRows x MaxColumns.
+ * Хранилище поля рассчитано на наибольший размер, поэтому LinesEngine::create
+ * берет наименьшие MaxRows и MaxColumns, вмещающие поле
+ */
+template <int MaxRows, int MaxColumns>
+class DynamicGeometry {
+public:
+    enum {
+        MAX_ROWS    = MaxRows,
+        MAX_COLUMNS = MaxColumns,
+        MAX_CELLS   = MaxRows * MaxColumns
+    };
+
+    DynamicGeometry()
+        : m_rows(MaxRows), m_columns(MaxColumns) {
+    }
+
+    DynamicGeometry(int rows, int columns)
+        : m_rows(rows), m_columns(columns) {
+    }
+
+    int rows() const {
+        return m_rows;
+    }
+
+    int columns() const {
+        return m_columns;
+    }
+
+    int cells() const {
+        return m_rows * m_columns;
+    }
+
+    int rowOf(int index) const {
+        return index / m_columns;
+    }
+
+    int columnOf(int index) const {
+        return index % m_columns;
+    }
+
+private:
+    int m_rows;
+    int m_columns;
+};
+
+#endif // BOARDGEOMETRY_H
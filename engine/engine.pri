@@ -0,0 +1,16 @@
+# Links the static rules engine into an application project
+INCLUDEPATH += $$PWD
+
+# Uncomment to compile the trace spans out of the engine and the application
+#DEFINES += LINES_NO_TRACE
+DEPENDPATH  += $$PWD
+
+ENGINE_OUT = $$OUT_PWD/../engine
+
+win32:CONFIG(release, debug|release): ENGINE_OUT = $$ENGINE_OUT/release
+else:win32:CONFIG(debug, debug|release): ENGINE_OUT = $$ENGINE_OUT/debug
+
+LIBS += -L$$ENGINE_OUT -lengine
+
+win32-g++|!win32: PRE_TARGETDEPS += $$ENGINE_OUT/libengine.a
+else: PRE_TARGETDEPS += $$ENGINE_OUT/engine.lib
@@ -0,0 +1,44 @@
+TEMPLATE = lib
+TARGET   = engine
+
+CONFIG += staticlib c++11 thread
+CONFIG -= qt
+
+# Uncomment together with the same line in engine.pri to compile the trace spans out
+#DEFINES += LINES_NO_TRACE
+
+SOURCES += \
+        batchengine.cpp \
+        expectimaxsearch.cpp \
+        hintsearch.cpp \
+        linescan.cpp \
+        linescan_avx2.cpp \
+        linescan_sse2.cpp \
+        linesengine.cpp \
+        movejournal.cpp \
+        movepolicy.cpp \
+        tracer.cpp \
+        transpositiontable.cpp \
+        undostack.cpp \
+        workstealingpool.cpp
+
+HEADERS += \
+    basiclinesengine.h \
+    batchengine.h \
+    bitops.h \
+    bitplane.h \
+    boardcore.h \
+    boardgeometry.h \
+    expectimaxsearch.h \
+    hintsearch.h \
+    lineindex.h \
+    linescan.h \
+    linescankernel.h \
+    linesengine.h \
+    movejournal.h \
+    movepolicy.h \
+    splitmix64.h \
+    tracer.h \
+    transpositiontable.h \
+    undostack.h \
+    workstealingpool.h
@@ -0,0 +1,307 @@
+#include "expectimaxsearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <numeric>
+
+#include "splitmix64.h"
+#include "tracer.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Состояние одного потока анализа: ограничения и буферы ходов на каждую глубину
+ */
+struct ExpectimaxSearch::Context {
+    const ExpectimaxOptions*        options;
+    const std::atomic<bool>*        cancel;
+    Clock::time_point               deadline;
+    uint64_t                        salt;
+    std::atomic<bool>*              expired;
+    long                            nodes     = 0;
+    long                            tableHits = 0;
+    std::vector<std::vector<Move>>  moves;
+    std::vector<std::vector<int>>   keys;
+
+    bool isExpired() {
+        if (expired->load(std::memory_order_relaxed))
+            return true;
+        if ((cancel && cancel->load(std::memory_order_relaxed)) ||
+                (options->budgetMs > 0 && Clock::now() >= deadline)) {
+            expired->store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+};
+
+ExpectimaxSearch::ExpectimaxSearch(WorkStealingPool& pool, TranspositionTable& table)
+    : m_pool(pool),
+      m_table(table) {
+}
+
+ExpectimaxResult ExpectimaxSearch::search(const LinesEngine& position, const ExpectimaxOptions& options,
+                                          const std::atomic<bool>* cancel) {
+    TRACE_SPAN("ExpectimaxSearch::search");
+    std::unique_ptr<LinesEngine> root = position.clone();
+    root->setListener(nullptr);
+    m_table.newSearch();
+
+    std::atomic<bool> expired(false);
+    Context shared;
+    shared.options = &options;
+    shared.cancel = cancel;
+    shared.deadline = Clock::now() + std::chrono::milliseconds(options.budgetMs);
+    // значения зависят от ширины и выборки, поэтому они входят в ключи таблицы
+    shared.salt = SplitMix64::mix((uint64_t(options.beamWidth) << 32) | uint64_t(options.samples));
+    shared.expired = &expired;
+
+    ExpectimaxResult result;
+    for (int depth = 1; depth <= std::max(1, options.depth); ++depth) {
+        ExpectimaxResult pass;
+        bool isComplete = searchDepth(*root, depth, shared, pass);
+        result.nodes += pass.nodes;
+        result.tableHits += pass.tableHits;
+        if (isComplete) {
+            pass.nodes = result.nodes;
+            pass.tableHits = result.tableHits;
+            result = pass;
+            continue;
+        }
+        // незаконченный проход полезен, только если полного еще нет
+        if (!result.found && pass.found) {
+            pass.nodes = result.nodes;
+            pass.tableHits = result.tableHits;
+            result = pass;
+        }
+        break;
+    }
+    return result;
+}
+
+/**
+ * @brief ExpectimaxSearch::searchDepth
+ * Один проход на глубину depth: ходы корня оцениваются параллельно,
+ * среди равных выбирается более ранний в порядке перебора
+ * * @return true - если оценены все ходы корня
+ */
+bool ExpectimaxSearch::searchDepth(const LinesEngine& position, int depth, Context& shared,
+                                   ExpectimaxResult& result) {
+    const ExpectimaxOptions& options = *shared.options;
+    // корень рассматривает больше ходов, чем узлы в глубине, поэтому хранится под своими ключами
+    const uint64_t rootSalt = SplitMix64::mix(shared.salt ^ uint64_t(options.rootWidth));
+    TableEntry entry;
+    Move first;
+    if (m_table.probe(nodeKey(position.hash(), depth - 1, false, rootSalt), entry))
+        first = entry.best;
+    std::vector<Move> moves;
+    std::vector<int> keys;
+    orderMoves(position, options.rootWidth, first, moves, keys);
+    const int count = int(moves.size());
+    if (count == 0)
+        return true;
+
+    std::vector<int> values(count, INT_MIN);
+    std::atomic<long> nodes(0);
+    std::atomic<long> tableHits(0);
+    m_pool.parallelFor(0, count, 1, [&](int begin, int end) {
+        Context context = shared;
+        context.moves.resize(depth + 1);
+        context.keys.resize(depth + 1);
+        for (int i = begin; i < end; ++i) {
+            if (context.isExpired())
+                break;
+            std::unique_ptr<LinesEngine> child = position.clone();
+            int before = child->score();
+            child->moveCell(moves[i].from, moves[i].to);
+            child->checkAndApplyWinLines(moves[i].to);
+            int value = (child->score() - before) * VALUE_SCALE + chanceValue(*child, depth, context);
+            if (!context.isExpired())
+                values[i] = value;
+        }
+        nodes.fetch_add(context.nodes);
+        tableHits.fetch_add(context.tableHits);
+    });
+
+    result.nodes = nodes.load();
+    result.tableHits = tableHits.load();
+    int bestIndex = -1;
+    bool isComplete = true;
+    for (int i = 0; i < count; ++i) {
+        if (values[i] == INT_MIN) {
+            isComplete = false;
+            continue;
+        }
+        if (bestIndex < 0 || values[i] > values[bestIndex])
+            bestIndex = i;
+    }
+    if (bestIndex < 0)
+        return false;
+    result.move = moves[bestIndex];
+    result.value = double(values[bestIndex]) / VALUE_SCALE;
+    result.depth = depth;
+    result.found = true;
+    result.complete = isComplete;
+    if (isComplete)
+        m_table.store(nodeKey(position.hash(), depth, false, rootSalt), values[bestIndex], depth,
+                      result.move);
+    return isComplete;
+}
+
+/**
+ * @brief ExpectimaxSearch::decisionValue
+ * Значение узла выбора: лучший из beamWidth самых перспективных ходов
+ * * @param depth - оставшихся ходов игрока, не меньше 1
+ */
+int ExpectimaxSearch::decisionValue(const LinesEngine& position, int depth, Context& context) {
+    const uint64_t key = nodeKey(position.hash(), depth, false, context.salt);
+    TableEntry entry;
+    if (m_table.probe(key, entry)) {
+        ++context.tableHits;
+        return entry.value;
+    }
+    if (context.isExpired())
+        return 0;
+    ++context.nodes;
+
+    std::vector<Move>& moves = context.moves[depth];
+    orderMoves(position, context.options->beamWidth, Move(), moves, context.keys[depth]);
+    if (moves.empty())
+        return leafValue(position);
+
+    int bestValue = INT_MIN;
+    Move bestMove;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const Move move = moves[i];
+        std::unique_ptr<LinesEngine> child = position.clone();
+        int before = child->score();
+        child->moveCell(move.from, move.to);
+        child->checkAndApplyWinLines(move.to);
+        int value = (child->score() - before) * VALUE_SCALE + chanceValue(*child, depth, context);
+        if (value > bestValue) {
+            bestValue = value;
+            bestMove = move;
+        }
+    }
+    if (context.isExpired())
+        return 0;
+    m_table.store(key, bestValue, depth, bestMove);
+    return bestValue;
+}
+
+/**
+ * @brief ExpectimaxSearch::chanceValue
+ * Значение узла случая: среднее по выборке исходов появления фигур
+ * * @param depth - оставшихся ходов игрока, включая только что сделанный
+ */
+int ExpectimaxSearch::chanceValue(const LinesEngine& position, int depth, Context& context) {
+    const uint64_t key = nodeKey(position.hash(), depth, true, context.salt);
+    TableEntry entry;
+    if (m_table.probe(key, entry)) {
+        ++context.tableHits;
+        return entry.value;
+    }
+    if (context.isExpired())
+        return 0;
+    ++context.nodes;
+
+    const int samples = std::max(1, context.options->samples);
+    long sum = 0;
+    for (int i = 0; i < samples; ++i) {
+        std::unique_ptr<LinesEngine> child = position.clone();
+        int before = child->score();
+        spawnSample(*child, SplitMix64::mix(key + uint64_t(i)));
+        int value = (child->score() - before) * VALUE_SCALE;
+        if (child->isFinal() || depth <= 1)
+            value += leafValue(*child);
+        else
+            value += decisionValue(*child, depth - 1, context);
+        sum += value;
+    }
+    int value = int(sum / samples);
+    if (context.isExpired())
+        return 0;
+    m_table.store(key, value, depth, Move());
+    return value;
+}
+
+/**
+ * @brief ExpectimaxSearch::leafValue
+ * Оценка позиции без перебора: чем больше свободных ячеек, тем дольше продлится партия,
+ * а серии на одну фигуру короче линии (все цвета, один проход LineScan) - ближайшие очки
+ */
+int ExpectimaxSearch::leafValue(const LinesEngine& position) const {
+    if (position.isFinal())
+        return LOSS_VALUE;
+    return position.freeCount() * FREE_CELL_VALUE
+            + position.countLines(position.rules().lengthWin - 1) * NEAR_LINE_VALUE;
+}
+
+/**
+ * @brief ExpectimaxSearch::orderMoves
+ * Оставляет width самых длинных по серии ходов, ход first (из таблицы) ставит первым
+ */
+void ExpectimaxSearch::orderMoves(const LinesEngine& position, int width, const Move& first,
+                                  std::vector<Move>& moves, std::vector<int>& keys) const {
+    position.legalMoves(moves);
+    const int count = int(moves.size());
+    keys.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const Move& move = moves[i];
+        keys[i] = (move.from == first.from && move.to == first.to) ? INT_MAX
+                                                                   : position.longestRunIfMoved(move);
+    }
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    const int kept = std::min(count, std::max(1, width));
+    std::partial_sort(order.begin(), order.begin() + kept, order.end(), [&keys](int a, int b) {
+        return keys[a] != keys[b] ? keys[a] > keys[b] : a < b;
+    });
+    std::vector<Move> ordered(kept);
+    for (int i = 0; i < kept; ++i)
+        ordered[i] = moves[order[i]];
+    moves.swap(ordered);
+}
+
+/**
+ * @brief ExpectimaxSearch::spawnSample
+ * Размещает spawnCount фигур как ход компьютера, но выбирает ячейки по номеру на поле,
+ * а не по позиции в массиве свободных ячеек: исход зависит только от расстановки и зерна
+ */
+void ExpectimaxSearch::spawnSample(LinesEngine& position, uint64_t seed) const {
+    SplitMix64 random(seed);
+    const LinesRules& rules = position.rules();
+    const int cellsCount = position.cells();
+    int spawned[16];
+    int count = 0;
+    for (int k = 0; k < rules.spawnCount && k < 16 && !position.isFinal(); ++k) {
+        int index = random.bounded(cellsCount);
+        for (int tries = 0; tries < 8 && position.isBusy(index); ++tries)
+            index = random.bounded(cellsCount);
+        while (position.isBusy(index))
+            index = (index + 1) % cellsCount;
+        position.restoreCell(index, random.bounded(rules.colorsCount) + 1);
+        spawned[count++] = index;
+    }
+    for (int i = 0; i < count; ++i)
+        position.checkAndApplyWinLines(spawned[i]);
+}
+
+uint64_t ExpectimaxSearch::nodeKey(uint64_t hash, int depth, bool isChance, uint64_t salt) {
+    return hash ^ SplitMix64::mix(salt + uint64_t(depth) * 2 + (isChance ? 1 : 0));
+}
+
+ExpectimaxMovePolicy::ExpectimaxMovePolicy(WorkStealingPool& pool, TranspositionTable& table,
+                                           const ExpectimaxOptions& options)
+    : m_search(pool, table),
+      m_options(options) {
+}
+
+bool ExpectimaxMovePolicy::chooseMove(const LinesEngine& engine, Move& move) {
+    ExpectimaxResult result = m_search.search(engine, m_options);
+    if (!result.found)
+        return false;
+    move = result.move;
+    return true;
+}
@@ -0,0 +1,97 @@
+#ifndef EXPECTIMAXSEARCH_H
+#define EXPECTIMAXSEARCH_H
+
+#include <atomic>
+#include <vector>
+
+#include "linesengine.h"
+#include "movepolicy.h"
+#include "transpositiontable.h"
+#include "workstealingpool.h"
+
+/**
+ * Параметры анализа
+ */
+struct ExpectimaxOptions {
+    int depth     = 2;   // ходов игрока вперед
+    int rootWidth = 16;  // ходов, рассматриваемых в корне
+    int beamWidth = 6;   // ходов, рассматриваемых в глубине
+    int samples   = 6;   // исходов появления фигур на узел случая
+    int budgetMs  = 0;   // ограничение по времени, 0 - без ограничения
+};
+
+/**
+ * Результат анализа
+ */
+struct ExpectimaxResult {
+    Move   move;
+    double value     = 0;      // оценка в очках: ожидаемые очки и запас свободных ячеек
+    int    depth     = 0;      // глубина последнего полностью просчитанного прохода
+    bool   found     = false;
+    bool   complete  = false;
+    long   nodes     = 0;
+    long   tableHits = 0;
+};
+
+/**
+ * Анализ на несколько ходов вперед методом expectimax.
+ * Узел выбора - ход игрока, узел случая - появление spawnCount фигур после хода.
+ * Исходы появления не перебираются полностью (их число растет как сочетания свободных ячеек),
+ * а берутся выборкой samples исходов, зерно которой зависит только от позиции и глубины.
+ * Поэтому значение узла - функция позиции и оставшейся глубины, и его можно брать
+ * из таблицы транспозиций по хешу Зобриста, в том числе в следующих анализах.
+ * Ходы корня оцениваются параллельно в пуле с общей таблицей, глубина наращивается
+ * итеративно, пока хватает времени
+ */
+class ExpectimaxSearch {
+public:
+    enum {
+        VALUE_SCALE     = 16,    // единиц значения в одном очке
+        FREE_CELL_VALUE = 2,     // ценность свободной ячейки в листе
+        NEAR_LINE_VALUE = 8,     // ценность серии на одну фигуру короче линии
+        LOSS_VALUE      = -1600  // конец игры
+    };
+
+    ExpectimaxSearch(WorkStealingPool& pool, TranspositionTable& table);
+
+    /**
+     * @brief ExpectimaxSearch::search
+     * * @param position - позиция, в которой ищется ход
+     * * @param cancel - флаг отмены, может выставляться из другого потока
+     * * @return лучший ход последнего полного прохода, либо лучший из оцененных
+     */
+    ExpectimaxResult search(const LinesEngine& position, const ExpectimaxOptions& options,
+                            const std::atomic<bool>* cancel = nullptr);
+
+private:
+    struct Context;
+
+    WorkStealingPool&   m_pool;
+    TranspositionTable& m_table;
+
+    bool searchDepth(const LinesEngine& position, int depth, Context& shared, ExpectimaxResult& result);
+    int  decisionValue(const LinesEngine& position, int depth, Context& context);
+    int  chanceValue(const LinesEngine& position, int depth, Context& context);
+    int  leafValue(const LinesEngine& position) const;
+    void orderMoves(const LinesEngine& position, int width, const Move& first,
+                    std::vector<Move>& moves, std::vector<int>& keys) const;
+    void spawnSample(LinesEngine& position, uint64_t seed) const;
+    static uint64_t nodeKey(uint64_t hash, int depth, bool isChance, uint64_t salt);
+};
+
+/**
+ * Стратегия самоигры на основе анализа expectimax
+ */
+class ExpectimaxMovePolicy : public MovePolicy {
+public:
+    ExpectimaxMovePolicy(WorkStealingPool& pool, TranspositionTable& table,
+                         const ExpectimaxOptions& options);
+
+    bool chooseMove(const LinesEngine& engine, Move& move) override;
+
+private:
+    ExpectimaxSearch  m_search;
+    ExpectimaxOptions m_options;
+};
+
+#endif // EXPECTIMAXSEARCH_H
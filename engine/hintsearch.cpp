@@ -0,0 +1,114 @@
+#include "hintsearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#include "tracer.h"
+
+int RunLengthHeuristic::evaluate(LinesEngine& position, const Move& move) const {
+    return position.longestRunIfMoved(move);
+}
+
+/**
+ * @brief LookaheadHeuristic::evaluate
+ * Делает ход в копии позиции и перебирает все ответные ходы игрока без учета
+ * появления новых фигур
+ */
+int LookaheadHeuristic::evaluate(LinesEngine& position, const Move& move) const {
+    static thread_local std::vector<Move> next;
+    int run = position.longestRunIfMoved(move);
+    position.moveCell(move.from, move.to);
+    int lines = position.checkAndApplyWinLines(move.to);
+    position.legalMoves(next);
+    int follow = 0;
+    for (const Move& candidate : next)
+        follow = std::max(follow, position.longestRunIfMoved(candidate));
+    return lines * 10000 + follow * 100 + run;
+}
+
+HintSearch::HintSearch(WorkStealingPool& pool, const MoveHeuristic& heuristic)
+    : m_pool(pool),
+      m_heuristic(heuristic) {
+}
+
+HintResult HintSearch::search(const LinesEngine& position, int budgetMs,
+                              const std::atomic<bool>* cancel) {
+    TRACE_SPAN("HintSearch::search");
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(budgetMs);
+
+    HintResult result;
+    // перечисление строит метки областей позиции, поэтому выполняется до запуска потоков
+    position.legalMoves(m_moves);
+    const int count = int(m_moves.size());
+    result.total = count;
+    if (count == 0) {
+        result.complete = true;
+        return result;
+    }
+    m_keys.resize(count);
+    for (int i = 0; i < count; ++i)
+        m_keys[i] = position.longestRunIfMoved(m_moves[i]);
+    m_order.resize(count);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b) {
+        return m_keys[a] > m_keys[b];
+    });
+
+    // оценка в старших разрядах, дополнение номера в порядке - в младших:
+    // максимум упакованного значения - лучший ход, при равенстве более ранний
+    std::atomic<int64_t> best(-1);
+    std::atomic<int>     evaluated(0);
+    std::atomic<bool>    expired(false);
+    m_pool.parallelFor(0, count, GRAIN, [&](int begin, int end) {
+        int64_t localBest = -1;
+        int localCount = 0;
+        for (int i = begin; i < end; ++i) {
+            if (expired.load(std::memory_order_relaxed))
+                break;
+            if ((cancel && cancel->load(std::memory_order_relaxed)) ||
+                    (budgetMs > 0 && Clock::now() >= deadline)) {
+                expired.store(true, std::memory_order_relaxed);
+                break;
+            }
+            std::unique_ptr<LinesEngine> scratch = position.clone();
+            scratch->setListener(nullptr);
+            int score = m_heuristic.evaluate(*scratch, m_moves[m_order[i]]);
+            int64_t packed = (int64_t(score) << 32) | int64_t(0xFFFFFFFFu - uint32_t(i));
+            localBest = std::max(localBest, packed);
+            ++localCount;
+        }
+        evaluated.fetch_add(localCount);
+        int64_t current = best.load();
+        while (localBest > current && !best.compare_exchange_weak(current, localBest)) {
+        }
+    });
+
+    result.evaluated = evaluated.load();
+    result.complete = !expired.load() && result.evaluated == count;
+    int64_t packed = best.load();
+    if (packed < 0) {
+        // время вышло до первой оценки: лучший ход по предварительному порядку
+        result.move = m_moves[m_order[0]];
+        result.score = 0;
+        return result;
+    }
+    int index = int(0xFFFFFFFFu - uint32_t(packed & 0xFFFFFFFF));
+    result.move = m_moves[m_order[index]];
+    result.score = int(packed >> 32);
+    return result;
+}
+
+HintMovePolicy::HintMovePolicy(WorkStealingPool& pool, int budgetMs)
+    : m_search(pool, m_heuristic),
+      m_budgetMs(budgetMs) {
+}
+
+bool HintMovePolicy::chooseMove(const LinesEngine& engine, Move& move) {
+    HintResult result = m_search.search(engine, m_budgetMs);
+    if (result.score < 0)
+        return false;
+    move = result.move;
+    return true;
+}
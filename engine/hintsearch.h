@@ -0,0 +1,103 @@
+#ifndef HINTSEARCH_H
+#define HINTSEARCH_H
+
+#include <atomic>
+#include <vector>
+
+#include "linesengine.h"
+#include "movepolicy.h"
+#include "workstealingpool.h"
+
+/**
+ * Оценка хода для поиска подсказки. Вызывается одновременно из нескольких потоков,
+ * поэтому не должна менять собственное состояние
+ */
+class MoveHeuristic {
+public:
+    virtual ~MoveHeuristic() {}
+
+    /**
+     * @brief MoveHeuristic::evaluate
+     * * @param position - собственная копия позиции до хода, ее можно менять
+     * * @param move - допустимый ход
+     * * @return оценка хода, больше - лучше, не меньше нуля
+     */
+    virtual int evaluate(LinesEngine& position, const Move& move) const = 0;
+};
+
+/**
+ * Длина самой длинной серии через целевую ячейку, как у жадной стратегии
+ */
+class RunLengthHeuristic : public MoveHeuristic {
+public:
+    int evaluate(LinesEngine& position, const Move& move) const override;
+};
+
+/**
+ * Ход с просмотром на полхода вперед: собранные линии ценятся выше всего,
+ * затем длина серии после хода и лучшая серия, которую можно получить следующим ходом
+ */
+class LookaheadHeuristic : public MoveHeuristic {
+public:
+    int evaluate(LinesEngine& position, const Move& move) const override;
+};
+
+/**
+ * Результат поиска подсказки
+ */
+struct HintResult {
+    Move move;
+    int  score     = -1;
+    int  evaluated = 0;
+    int  total     = 0;
+    bool complete  = false;
+};
+
+/**
+ * Поиск лучшего хода: перебирает все допустимые ходы и оценивает их параллельно в пуле.
+ * Ходы заранее упорядочены дешевой оценкой, поэтому при нехватке времени
+ * первыми оцениваются самые перспективные. Среди равных оценок выбирается ход,
+ * стоящий раньше в этом порядке, поэтому полный поиск не зависит от числа потоков
+ */
+class HintSearch {
+public:
+    enum {
+        GRAIN = 8
+    };
+
+    HintSearch(WorkStealingPool& pool, const MoveHeuristic& heuristic);
+
+    /**
+     * @brief HintSearch::search
+     * * @param position - позиция, в которой ищется ход
+     * * @param budgetMs - ограничение по времени, 0 - без ограничения
+     * * @param cancel - флаг отмены, может выставляться из другого потока
+     * * @return лучший из оцененных ходов, score < 0 - если ходов нет
+     */
+    HintResult search(const LinesEngine& position, int budgetMs,
+                      const std::atomic<bool>* cancel = nullptr);
+
+private:
+    WorkStealingPool&    m_pool;
+    const MoveHeuristic& m_heuristic;
+    std::vector<Move>    m_moves;
+    std::vector<int>     m_order;
+    std::vector<int>     m_keys;
+};
+
+/**
+ * Сильнейшая стратегия самоигры: лучший ход по поиску подсказки
+ */
+class HintMovePolicy : public MovePolicy {
+public:
+    HintMovePolicy(WorkStealingPool& pool, int budgetMs);
+
+    bool chooseMove(const LinesEngine& engine, Move& move) override;
+
+private:
+    LookaheadHeuristic m_heuristic;
+    HintSearch         m_search;
+    int                m_budgetMs;
+};
+
+#endif // HINTSEARCH_H
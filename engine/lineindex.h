@@ -0,0 +1,202 @@
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bitops.h"
+
+/**
+ * Непрерывная линия одноцветных фигур: первая ячейка, шаг индекса и длина
+ */
+struct LineRun {
+    int start  = -1;
+    int step   = 0;
+    int length = 0;
+};
+
+/**
+ * Индекс линий поля: для каждого цвета по одной битовой маске на строку, столбец и обе диагонали.
+ * Маска линии хранит по биту на ячейку, поэтому размещение и снятие фигуры обновляют 4 слова,
+ * а границы серии вокруг ячейки находятся подсчетом нулевых бит за постоянное время.
+ */
+template <class Geometry, size_t Colors>
+class LineIndex {
+    static_assert(Geometry::MAX_ROWS <= 64 && Geometry::MAX_COLUMNS <= 64,
+                  "line masks are limited to 64 cells");
+public:
+    enum {
+        MAX_DIAGONALS = Geometry::MAX_ROWS + Geometry::MAX_COLUMNS - 1
+    };
+
+    explicit LineIndex(const Geometry& geometry = Geometry())
+        : m_geometry(geometry) {
+        clear();
+    }
+
+    void clear() {
+        const int diagonals = m_geometry.rows() + m_geometry.columns() - 1;
+        for (size_t c = 0; c < Colors; ++c) {
+            for (int i = 0; i < m_geometry.rows(); ++i)
+                m_rows[c][i] = 0;
+            for (int i = 0; i < m_geometry.columns(); ++i)
+                m_columns[c][i] = 0;
+            for (int i = 0; i < diagonals; ++i) {
+                m_diagonals[c][i] = 0;
+                m_antiDiagonals[c][i] = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief LineIndex::place
+     * Отмечает фигуру цвета idColor в ячейке index во всех четырех направлениях
+     */
+    void place(int index, int idColor) {
+        int row = m_geometry.rowOf(index);
+        int column = m_geometry.columnOf(index);
+        int c = idColor - 1;
+        m_rows[c][row]                            |= bit(column);
+        m_columns[c][column]                      |= bit(row);
+        m_diagonals[c][diagonalOf(row, column)]   |= bit(row);
+        m_antiDiagonals[c][row + column]          |= bit(row);
+    }
+
+    /**
+     * @brief LineIndex::remove
+     * Снимает отметку фигуры цвета idColor в ячейке index
+     */
+    void remove(int index, int idColor) {
+        int row = m_geometry.rowOf(index);
+        int column = m_geometry.columnOf(index);
+        int c = idColor - 1;
+        m_rows[c][row]                            &= ~bit(column);
+        m_columns[c][column]                      &= ~bit(row);
+        m_diagonals[c][diagonalOf(row, column)]   &= ~bit(row);
+        m_antiDiagonals[c][row + column]          &= ~bit(row);
+    }
+
+    /**
+     * @brief LineIndex::linesThrough
+     * Находит все линии цвета idColor длиной не меньше minLength, проходящие через index
+     * * @param out - массив для найденных линий (по одной на направление)
+     * * @return количество найденных линий
+     */
+    int linesThrough(int index, int idColor, int minLength, LineRun out[4]) const {
+        const int columns = m_geometry.columns();
+        int row = m_geometry.rowOf(index);
+        int column = m_geometry.columnOf(index);
+        int c = idColor - 1;
+        int count = 0;
+        int first;
+        int length;
+
+        runAround(m_rows[c][row], column, first, length);
+        if (length >= minLength)
+            out[count++] = makeRun(row * columns + first, 1, length);
+
+        runAround(m_columns[c][column], row, first, length);
+        if (length >= minLength)
+            out[count++] = makeRun(first * columns + column, columns, length);
+
+        runAround(m_diagonals[c][diagonalOf(row, column)], row, first, length);
+        if (length >= minLength)
+            out[count++] = makeRun(first * columns + column - (row - first),
+                                   columns + 1, length);
+
+        runAround(m_antiDiagonals[c][row + column], row, first, length);
+        if (length >= minLength)
+            out[count++] = makeRun(first * columns + column + (row - first),
+                                   columns - 1, length);
+        return count;
+    }
+
+    /**
+     * @brief LineIndex::longestRunIfMoved
+     * Длина самой длинной серии цвета idColor через to, если перенести фигуру из from в to.
+     * Считается по копиям четырех масок, не изменяя индекс
+     */
+    int longestRunIfMoved(int from, int to, int idColor) const {
+        int rowFrom = m_geometry.rowOf(from);
+        int columnFrom = m_geometry.columnOf(from);
+        int row = m_geometry.rowOf(to);
+        int column = m_geometry.columnOf(to);
+        int c = idColor - 1;
+        int first;
+        int length;
+        int best = 0;
+
+        uint64_t mask = m_rows[c][row];
+        if (rowFrom == row)
+            mask &= ~bit(columnFrom);
+        runAround(mask | bit(column), column, first, length);
+        best = length > best ? length : best;
+
+        mask = m_columns[c][column];
+        if (columnFrom == column)
+            mask &= ~bit(rowFrom);
+        runAround(mask | bit(row), row, first, length);
+        best = length > best ? length : best;
+
+        mask = m_diagonals[c][diagonalOf(row, column)];
+        if (diagonalOf(rowFrom, columnFrom) == diagonalOf(row, column))
+            mask &= ~bit(rowFrom);
+        runAround(mask | bit(row), row, first, length);
+        best = length > best ? length : best;
+
+        mask = m_antiDiagonals[c][row + column];
+        if (rowFrom + columnFrom == row + column)
+            mask &= ~bit(rowFrom);
+        runAround(mask | bit(row), row, first, length);
+        best = length > best ? length : best;
+        return best;
+    }
+
+private:
+    Geometry m_geometry;
+    uint64_t m_rows[Colors][Geometry::MAX_ROWS];
+    uint64_t m_columns[Colors][Geometry::MAX_COLUMNS];
+    uint64_t m_diagonals[Colors][MAX_DIAGONALS];
+    uint64_t m_antiDiagonals[Colors][MAX_DIAGONALS];
+
+    int diagonalOf(int row, int column) const {
+        return row - column + m_geometry.columns() - 1;
+    }
+
+    static uint64_t bit(int position) {
+        return uint64_t(1) << position;
+    }
+
+    static LineRun makeRun(int start, int step, int length) {
+        LineRun run;
+        run.start = start;
+        run.step = step;
+        run.length = length;
+        return run;
+    }
+
+    /**
+     * @brief LineIndex::runAround
+     * Находит серию установленных бит маски, содержащую бит position
+     * * @param first - номер младшего бита серии
+     * * @param length - длина серии, 0 если бит position сброшен
+     */
+    static void runAround(uint64_t mask, int position, int& first, int& length) {
+        if (!((mask >> position) & 1u)) {
+            first = position;
+            length = 0;
+            return;
+        }
+        uint64_t inv = ~mask;
+        int up = BitOps::countTrailingZeros(inv >> position);
+        if (up > 64 - position)
+            up = 64 - position;
+        int down = BitOps::countLeadingZeros(inv << (63 - position));
+        if (down > position + 1)
+            down = position + 1;
+        first = position - down + 1;
+        length = up + down - 1;
+    }
+};
+
+#endif // LINEINDEX_H
@@ -0,0 +1,214 @@
+#include "linescan.h"
+
+#include <atomic>
+
+#if defined(LINESCAN_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#include "bitops.h"
+#include "linescankernel.h"
+
+namespace {
+
+/**
+ * Переносимая реализация: вектор из одной дорожки
+ */
+struct PortableOps {
+    typedef uint64_t Vec;
+
+    enum {
+        WIDTH = 1
+    };
+
+    static Vec load(const uint64_t* p)        { return *p; }
+    static void store(uint64_t* p, Vec v)     { *p = v; }
+    static Vec zero()                         { return 0; }
+    static Vec broadcast(uint64_t word)       { return word; }
+    static Vec bitAnd(Vec a, Vec b)           { return a & b; }
+    static Vec bitOr(Vec a, Vec b)            { return a | b; }
+    static Vec andNot(Vec a, Vec b)           { return a & ~b; }
+    static Vec shiftRight(Vec v, int count)   { return v >> count; }
+    static Vec shiftLeft(Vec v, int count)    { return v << count; }
+    static int popCount(Vec v)                { return BitOps::popCount(v); }
+    static uint64_t reduceOr(Vec v)           { return v; }
+};
+
+/**
+ * Маски начал и предшественников для размера поля и длины серии.
+ * Пересчитываются только при их смене, поэтому хранятся отдельно в каждом потоке.
+ * Несколько наборов - так как оценка позиции чередует длины серий
+ */
+struct ScanMasks {
+    int      rows      = 0;
+    int      columns   = 0;
+    int      minLength = 0;
+    uint64_t starts[4][LineScan::MAX_WORDS];
+    uint64_t predecessors[4][LineScan::MAX_WORDS];
+};
+
+enum {
+    MASK_SETS = 4
+};
+
+thread_local ScanMasks masks[MASK_SETS];
+thread_local int       nextMasks = 0;
+
+std::atomic<int> activeKernel(-1);
+
+/**
+ * @brief columnRange
+ * Заполняет маску ячеек со столбцами first..last во всех строках
+ */
+void columnRange(uint64_t* out, int rows, int columns, int first, int last) {
+    const int words = LineScan::words(rows, columns);
+    for (int w = 0; w < words; ++w)
+        out[w] = 0;
+    if (first < 0)
+        first = 0;
+    if (last >= columns)
+        last = columns - 1;
+    for (int row = 0; row < rows; ++row)
+        for (int column = first; column <= last; ++column) {
+            int index = row * columns + column;
+            out[index >> 6] |= uint64_t(1) << (index & 63);
+        }
+}
+
+/**
+ * @brief prepareMasks
+ * Серия по направлению не должна переходить через край строки, поэтому ее начало
+ * ограничено по столбцам; выход за нижний край дает нулевые биты сам
+ */
+const ScanMasks& prepareMasks(int rows, int columns, int minLength) {
+    for (int i = 0; i < MASK_SETS; ++i) {
+        const ScanMasks& cached = masks[i];
+        if (cached.rows == rows && cached.columns == columns && cached.minLength == minLength)
+            return cached;
+    }
+    ScanMasks& m = masks[nextMasks];
+    nextMasks = (nextMasks + 1) % MASK_SETS;
+    const int tail = minLength - 1;
+    columnRange(m.starts[0], rows, columns, 0, columns - 1 - tail);    // горизонталь
+    columnRange(m.starts[1], rows, columns, 0, columns - 1);           // вертикаль
+    columnRange(m.starts[2], rows, columns, 0, columns - 1 - tail);    // диагональ
+    columnRange(m.starts[3], rows, columns, tail, columns - 1);        // побочная диагональ
+    columnRange(m.predecessors[0], rows, columns, 1, columns - 1);
+    columnRange(m.predecessors[1], rows, columns, 0, columns - 1);
+    columnRange(m.predecessors[2], rows, columns, 1, columns - 1);
+    columnRange(m.predecessors[3], rows, columns, 0, columns - 2);
+    m.rows = rows;
+    m.columns = columns;
+    m.minLength = minLength;
+    return m;
+}
+
+/**
+ * @brief cpuSupports
+ * * @return true, если процессор и система поддерживают набор команд реализации
+ */
+bool cpuSupports(LineScan::Kernel kernel) {
+    switch (kernel) {
+    case LineScan::PORTABLE:
+        return true;
+#if defined(LINESCAN_X86) && defined(_MSC_VER)
+    case LineScan::SSE2: {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] >> 26) & 1;
+    }
+    case LineScan::AVX2: {
+        int info[4];
+        __cpuid(info, 1);
+        bool hasAvx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return hasAvx && ((info[1] >> 5) & 1);
+    }
+#elif defined(LINESCAN_X86)
+    case LineScan::SSE2:
+        return __builtin_cpu_supports("sse2");
+    case LineScan::AVX2:
+        return __builtin_cpu_supports("avx2");
+#else
+    case LineScan::SSE2:
+    case LineScan::AVX2:
+        break;
+#endif
+    }
+    return false;
+}
+
+LineScan::Kernel bestKernel() {
+    if (cpuSupports(LineScan::AVX2))
+        return LineScan::AVX2;
+    if (cpuSupports(LineScan::SSE2))
+        return LineScan::SSE2;
+    return LineScan::PORTABLE;
+}
+
+} // namespace
+
+int lineScanPortable(const LineScanTask& task) {
+    return LineScanPass<PortableOps>::run(task);
+}
+
+int LineScan::scan(const uint64_t* planes, int rows, int columns, int minLength, uint64_t* lineCells) {
+    if (minLength < 1)
+        minLength = 1;
+    const ScanMasks& m = prepareMasks(rows, columns, minLength);
+    LineScanTask task;
+    task.planes = planes;
+    task.words = words(rows, columns);
+    task.minLength = minLength;
+    task.steps[0] = 1;
+    task.steps[1] = columns;
+    task.steps[2] = columns + 1;
+    task.steps[3] = columns - 1;
+    for (int d = 0; d < 4; ++d) {
+        task.startMasks[d] = m.starts[d];
+        task.predecessorMasks[d] = m.predecessors[d];
+    }
+    task.lineCells = lineCells;
+    switch (kernel()) {
+    case AVX2:
+        return lineScanAvx2(task);
+    case SSE2:
+        return lineScanSse2(task);
+    case PORTABLE:
+        break;
+    }
+    return lineScanPortable(task);
+}
+
+LineScan::Kernel LineScan::kernel() {
+    int current = activeKernel.load(std::memory_order_relaxed);
+    if (current < 0) {
+        current = bestKernel();
+        activeKernel.store(current, std::memory_order_relaxed);
+    }
+    return Kernel(current);
+}
+
+bool LineScan::setKernel(Kernel kernel) {
+    if (!cpuSupports(kernel))
+        return false;
+    activeKernel.store(kernel, std::memory_order_relaxed);
+    return true;
+}
+
+bool LineScan::isSupported(Kernel kernel) {
+    return cpuSupports(kernel);
+}
+
+const char* LineScan::kernelName(Kernel kernel) {
+    switch (kernel) {
+    case SSE2:
+        return "sse2";
+    case AVX2:
+        return "avx2";
+    case PORTABLE:
+        break;
+    }
+    return "portable";
+}
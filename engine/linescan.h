@@ -0,0 +1,79 @@
+#ifndef LINESCAN_H
+#define LINESCAN_H
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LINESCAN_X86
+#endif
+
+/**
+ * Поиск всех одноцветных линий поля за один проход: для всех цветов и всех четырех
+ * направлений сразу. Поле передается битовыми плоскостями, переставленными так,
+ * что одно слово всех цветов лежит подряд: plane[word][lane], цвет - номер дорожки.
+ * Поэтому сдвиги и И выполняются над всеми цветами одной векторной командой.
+ * Линия длиной не меньше L - пересечение плоскости с ее сдвигами на 1..L-1 шагов
+ * направления; сдвиги удваиваются, так что проход стоит O(log L) сдвигов на направление.
+ * Реализация (переносимая, SSE2 или AVX2) выбирается при запуске по возможностям процессора
+ */
+class LineScan {
+public:
+    enum Kernel {
+        PORTABLE,
+        SSE2,
+        AVX2
+    };
+
+    enum {
+        LANES     = 8,   // дорожек в слове плоскостей, не меньше числа цветов
+        MAX_WORDS = 64   // слов плоскости поля 64x64
+    };
+
+    /**
+     * @brief LineScan::scan
+     * Находит все максимальные одноцветные серии длиной не меньше minLength
+     * по горизонтали, вертикали и обеим диагоналям
+     * * @param planes - words() x LANES слов, биты ячеек за пределами поля нулевые
+     * * @param lineCells - если не nullptr, получает words() слов маски ячеек, входящих в серии
+     * * @return количество серий
+     */
+    static int scan(const uint64_t* planes, int rows, int columns, int minLength,
+                    uint64_t* lineCells = nullptr);
+
+    static int words(int rows, int columns) {
+        return (rows * columns + 63) / 64;
+    }
+
+    static Kernel kernel();
+
+    /**
+     * @brief LineScan::setKernel
+     * Выбирает реализацию, например для сравнения скорости
+     * * @return false - если процессор ее не поддерживает, выбор не меняется
+     */
+    static bool setKernel(Kernel kernel);
+
+    static bool        isSupported(Kernel kernel);
+    static const char* kernelName(Kernel kernel);
+};
+
+/**
+ * Задание для реализации прохода: плоскости и маски, общие для всех цветов
+ */
+struct LineScanTask {
+    const uint64_t* planes;
+    int             words;
+    int             minLength;
+    int             steps[4];              // шаг индекса ячейки по направлению
+    const uint64_t* startMasks[4];         // ячейки, с которых серия minLength не выходит за край
+    const uint64_t* predecessorMasks[4];   // ячейки, у которых есть предыдущая по направлению
+    uint64_t*       lineCells;
+};
+
+typedef int (*LineScanKernel)(const LineScanTask& task);
+
+int lineScanPortable(const LineScanTask& task);
+int lineScanSse2(const LineScanTask& task);
+int lineScanAvx2(const LineScanTask& task);
+
+#endif // LINESCAN_H
@@ -0,0 +1,82 @@
+#include "linescan.h"
+
+#ifdef LINESCAN_X86
+
+#include <cstdint>
+#include <utility>
+
+#include <immintrin.h>
+
+#include "bitops.h"
+
+// весь проход компилируется под набор команд реализации, остальной движок - без него
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "linescankernel.h"
+
+namespace {
+
+/**
+ * Реализация AVX2: четыре цвета в векторе
+ */
+struct Avx2Ops {
+    typedef __m256i Vec;
+
+    enum {
+        WIDTH = 4
+    };
+
+    static Vec load(const uint64_t* p)        { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint64_t* p, Vec v)     { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Vec zero()                         { return _mm256_setzero_si256(); }
+    static Vec broadcast(uint64_t word)       { return _mm256_set1_epi64x(static_cast<long long>(word)); }
+    static Vec bitAnd(Vec a, Vec b)           { return _mm256_and_si256(a, b); }
+    static Vec bitOr(Vec a, Vec b)            { return _mm256_or_si256(a, b); }
+    static Vec andNot(Vec a, Vec b)           { return _mm256_andnot_si256(b, a); }
+    static Vec shiftRight(Vec v, int count)   { return _mm256_srl_epi64(v, _mm_cvtsi32_si128(count)); }
+    static Vec shiftLeft(Vec v, int count)    { return _mm256_sll_epi64(v, _mm_cvtsi32_si128(count)); }
+
+    static int popCount(Vec v) {
+        uint64_t lanes[WIDTH];
+        store(lanes, v);
+        int count = 0;
+        for (int i = 0; i < WIDTH; ++i)
+            count += BitOps::popCount(lanes[i]);
+        return count;
+    }
+
+    static uint64_t reduceOr(Vec v) {
+        uint64_t lanes[WIDTH];
+        store(lanes, v);
+        uint64_t any = 0;
+        for (int i = 0; i < WIDTH; ++i)
+            any |= lanes[i];
+        return any;
+    }
+};
+
+} // namespace
+
+int lineScanAvx2(const LineScanTask& task) {
+    return LineScanPass<Avx2Ops>::run(task);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#else
+
+// вне x86 реализация не выбирается, но ссылка на нее должна разрешаться
+int lineScanAvx2(const LineScanTask& task) {
+    return lineScanPortable(task);
+}
+
+#endif // LINESCAN_X86
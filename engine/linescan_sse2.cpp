@@ -0,0 +1,82 @@
+#include "linescan.h"
+
+#ifdef LINESCAN_X86
+
+#include <cstdint>
+#include <utility>
+
+#include <emmintrin.h>
+
+#include "bitops.h"
+
+// весь проход компилируется под набор команд реализации, остальной движок - без него
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#include "linescankernel.h"
+
+namespace {
+
+/**
+ * Реализация SSE2: два цвета в векторе
+ */
+struct Sse2Ops {
+    typedef __m128i Vec;
+
+    enum {
+        WIDTH = 2
+    };
+
+    static Vec load(const uint64_t* p)        { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint64_t* p, Vec v)     { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec zero()                         { return _mm_setzero_si128(); }
+    static Vec broadcast(uint64_t word)       { return _mm_set1_epi64x(static_cast<long long>(word)); }
+    static Vec bitAnd(Vec a, Vec b)           { return _mm_and_si128(a, b); }
+    static Vec bitOr(Vec a, Vec b)            { return _mm_or_si128(a, b); }
+    static Vec andNot(Vec a, Vec b)           { return _mm_andnot_si128(b, a); }
+    static Vec shiftRight(Vec v, int count)   { return _mm_srl_epi64(v, _mm_cvtsi32_si128(count)); }
+    static Vec shiftLeft(Vec v, int count)    { return _mm_sll_epi64(v, _mm_cvtsi32_si128(count)); }
+
+    static int popCount(Vec v) {
+        uint64_t lanes[WIDTH];
+        store(lanes, v);
+        int count = 0;
+        for (int i = 0; i < WIDTH; ++i)
+            count += BitOps::popCount(lanes[i]);
+        return count;
+    }
+
+    static uint64_t reduceOr(Vec v) {
+        uint64_t lanes[WIDTH];
+        store(lanes, v);
+        uint64_t any = 0;
+        for (int i = 0; i < WIDTH; ++i)
+            any |= lanes[i];
+        return any;
+    }
+};
+
+} // namespace
+
+int lineScanSse2(const LineScanTask& task) {
+    return LineScanPass<Sse2Ops>::run(task);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#else
+
+// вне x86 реализация не выбирается, но ссылка на нее должна разрешаться
+int lineScanSse2(const LineScanTask& task) {
+    return lineScanPortable(task);
+}
+
+#endif // LINESCAN_X86
@@ -0,0 +1,177 @@
+#ifndef LINESCANKERNEL_H
+#define LINESCANKERNEL_H
+
+#include <cstdint>
+#include <utility>
+
+#include "linescan.h"
+
+/**
+ * Проход поиска линий, общий для всех реализаций. Ops задает вектор из WIDTH дорожек
+ * и операции над ним; файл реализации подключает этот заголовок уже с нужным набором
+ * команд процессора, поэтому экземпляр шаблона компилируется под него целиком.
+ * Слово w плоскостей - LANES дорожек подряд, по GROUPS векторов на слово.
+ * Рабочие буферы окружены нулевыми словами, поэтому сдвиги читают соседние слова
+ * без проверок границ
+ */
+template <class Ops>
+class LineScanPass {
+public:
+    typedef typename Ops::Vec Vec;
+
+    enum {
+        LANES    = LineScan::LANES,
+        GROUPS   = LineScan::LANES / Ops::WIDTH,
+        PADDING  = LineScan::MAX_WORDS,                                // нулевых слов с каждой стороны, не больше
+        CAPACITY = (LineScan::MAX_WORDS + 2 * PADDING) * LineScan::LANES
+    };
+
+    static int run(const LineScanTask& task) {
+        uint64_t planeBuffer[CAPACITY];
+        uint64_t bufferA[CAPACITY];
+        uint64_t bufferB[CAPACITY];
+        uint64_t startBuffer[CAPACITY];
+        const int words = task.words;
+        const int length = task.minLength;
+
+        // сдвиг дальше words слов дает ноль и считается отдельно, поэтому ближних нулей хватает
+        int longest = 0;
+        for (int d = 0; d < 4; ++d)
+            if (task.steps[d] > longest)
+                longest = task.steps[d];
+        int shiftWords = ((length - 1) * longest >> 6) + 1;
+        const int padding = (shiftWords < words ? shiftWords : words) + 1;
+
+        uint64_t* planes = prepare(planeBuffer, words, padding);
+        uint64_t* spare = prepare(bufferA, words, padding);
+        uint64_t* next = prepare(bufferB, words, padding);
+        uint64_t* starts = prepare(startBuffer, words, padding);
+        for (int i = 0; i < words * LANES; ++i)
+            planes[i] = task.planes[i];
+        if (task.lineCells)
+            for (int w = 0; w < words; ++w)
+                task.lineCells[w] = 0;
+
+        int runs = 0;
+        for (int d = 0; d < 4; ++d) {
+            const int step = task.steps[d];
+            // windows(i) - И плоскости по ячейкам i, i + step, ... : длина окна удваивается
+            const uint64_t* windows = planes;
+            for (int covered = 1; covered < length; ) {
+                int extra = covered < length - covered ? covered : length - covered;
+                andShiftedRight(next, windows, extra * step, words);
+                windows = next;
+                std::swap(next, spare);
+                covered += extra;
+            }
+
+            // начала окон внутри поля; серия начинается там, где предыдущая ячейка другого цвета
+            for (int w = 0; w < words; ++w) {
+                const Vec start = Ops::broadcast(task.startMasks[d][w]);
+                const Vec predecessor = Ops::broadcast(task.predecessorMasks[d][w]);
+                for (int g = 0; g < GROUPS; ++g) {
+                    Vec fits = Ops::bitAnd(load(windows, w, g), start);
+                    Vec before = Ops::bitAnd(shiftedLeft(planes, w, g, step), predecessor);
+                    runs += Ops::popCount(Ops::andNot(fits, before));
+                    Ops::store(starts + w * LANES + g * Ops::WIDTH, fits);
+                }
+            }
+            if (!task.lineCells)
+                continue;
+
+            // ячейки серий: начала окон, растянутые на длину окна
+            const uint64_t* cells = starts;
+            for (int covered = 1; covered < length; ) {
+                int extra = covered < length - covered ? covered : length - covered;
+                orShiftedLeft(next, cells, extra * step, words);
+                cells = next;
+                std::swap(next, spare);
+                covered += extra;
+            }
+            for (int w = 0; w < words; ++w) {
+                Vec any = Ops::zero();
+                for (int g = 0; g < GROUPS; ++g)
+                    any = Ops::bitOr(any, load(cells, w, g));
+                task.lineCells[w] |= Ops::reduceOr(any);
+            }
+        }
+        return runs;
+    }
+
+private:
+    /**
+     * @brief LineScanPass::prepare
+     * Обнуляет padding слов по обе стороны от рабочей области буфера
+     * * @return начало рабочей области
+     */
+    static uint64_t* prepare(uint64_t* buffer, int words, int padding) {
+        uint64_t* area = buffer + PADDING * LANES;
+        for (int i = 0; i < padding * LANES; ++i) {
+            area[-1 - i] = 0;
+            area[words * LANES + i] = 0;
+        }
+        return area;
+    }
+
+    static Vec load(const uint64_t* planes, int w, int g) {
+        return Ops::load(planes + w * LANES + g * Ops::WIDTH);
+    }
+
+    /**
+     * @brief LineScanPass::shiftedRight
+     * * @return слово w плоскостей, сдвинутых на shift ячеек к младшим: бит i - ячейка i + shift
+     */
+    static Vec shiftedRight(const uint64_t* planes, int w, int g, int shift) {
+        const int q = shift >> 6;
+        const int r = shift & 63;
+        Vec low = load(planes, w + q, g);
+        if (r == 0)
+            return low;
+        Vec high = load(planes, w + q + 1, g);
+        return Ops::bitOr(Ops::shiftRight(low, r), Ops::shiftLeft(high, 64 - r));
+    }
+
+    /**
+     * @brief LineScanPass::shiftedLeft
+     * * @return слово w плоскостей, сдвинутых на shift ячеек к старшим: бит i - ячейка i - shift
+     */
+    static Vec shiftedLeft(const uint64_t* planes, int w, int g, int shift) {
+        const int q = shift >> 6;
+        const int r = shift & 63;
+        Vec high = load(planes, w - q, g);
+        if (r == 0)
+            return high;
+        Vec low = load(planes, w - q - 1, g);
+        return Ops::bitOr(Ops::shiftLeft(high, r), Ops::shiftRight(low, 64 - r));
+    }
+
+    static void andShiftedRight(uint64_t* out, const uint64_t* planes, int shift, int words) {
+        if (shift >= words * 64) {
+            fill(out, words);
+            return;
+        }
+        for (int w = 0; w < words; ++w)
+            for (int g = 0; g < GROUPS; ++g)
+                Ops::store(out + w * LANES + g * Ops::WIDTH,
+                           Ops::bitAnd(load(planes, w, g), shiftedRight(planes, w, g, shift)));
+    }
+
+    static void orShiftedLeft(uint64_t* out, const uint64_t* planes, int shift, int words) {
+        if (shift >= words * 64) {
+            for (int i = 0; i < words * LANES; ++i)
+                out[i] = planes[i];
+            return;
+        }
+        for (int w = 0; w < words; ++w)
+            for (int g = 0; g < GROUPS; ++g)
+                Ops::store(out + w * LANES + g * Ops::WIDTH,
+                           Ops::bitOr(load(planes, w, g), shiftedLeft(planes, w, g, shift)));
+    }
+
+    static void fill(uint64_t* out, int words) {
+        for (int i = 0; i < words * LANES; ++i)
+            out[i] = 0;
+    }
+};
+
+#endif // LINESCANKERNEL_H
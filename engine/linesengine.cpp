@@ -0,0 +1,169 @@
+#include "linesengine.h"
+
+#include "basiclinesengine.h"
+
+namespace {
+
+template <class Geometry>
+std::unique_ptr<LinesEngine> makeEngine(const LinesRules& rules, const Geometry& geometry = Geometry()) {
+    return std::unique_ptr<LinesEngine>(new BasicLinesEngine<Geometry>(rules, geometry));
+}
+
+} // namespace
+
+/**
+ * @brief LinesEngine::create
+ * Создает движок для поля rows x columns. Для квадратных полей 9, 16, 32 и 64
+ * используется специализация с размером, известным при компиляции.
+ * Остальные поля получают наименьшее из хранилищ 16x16, 32x32 и 64x64, в которое
+ * они помещаются: clone копирует все хранилище, и для поля 10x12 хранилище 64x64
+ * (около 60 КБ) замедляет копирование узла поиска больше чем в десять раз
+ * * @return движок, либо nullptr, если размер вне 1..MAX_SIDE
+ */
+std::unique_ptr<LinesEngine> LinesEngine::create(int rows, int columns, const LinesRules& rules) {
+    if (rows < 1 || columns < 1 || rows > MAX_SIDE || columns > MAX_SIDE)
+        return std::unique_ptr<LinesEngine>();
+    if (rows == columns) {
+        switch (rows) {
+        case 9:
+            return makeEngine<FixedGeometry<9, 9> >(rules);
+        case 16:
+            return makeEngine<FixedGeometry<16, 16> >(rules);
+        case 32:
+            return makeEngine<FixedGeometry<32, 32> >(rules);
+        case 64:
+            return makeEngine<FixedGeometry<64, 64> >(rules);
+        }
+    }
+    const int side = rows > columns ? rows : columns;
+    if (side <= 16)
+        return makeEngine(rules, DynamicGeometry<16, 16>(rows, columns));
+    if (side <= 32)
+        return makeEngine(rules, DynamicGeometry<32, 32>(rows, columns));
+    return makeEngine(rules, DynamicGeometry<MAX_SIDE, MAX_SIDE>(rows, columns));
+}
+
+LinesEngine::LinesEngine(const LinesRules& rules)
+    : m_rules(rules) {
+    if (m_rules.colorsCount < 1)
+        m_rules.colorsCount = 1;
+    if (m_rules.colorsCount > MAX_COLORS)
+        m_rules.colorsCount = MAX_COLORS;
+    m_spawned.reserve(m_rules.spawnCount);
+}
+
+void LinesEngine::setListener(LinesEngineListener* listener) {
+    m_listener = listener;
+}
+
+const LinesRules& LinesEngine::rules() const {
+    return m_rules;
+}
+
+int LinesEngine::score() const {
+    return m_score;
+}
+
+void LinesEngine::setScore(int newScore) {
+    if (m_score == newScore)
+        return;
+    m_score = newScore;
+    if (m_listener)
+        m_listener->scoreChanged(m_score);
+}
+
+uint64_t LinesEngine::seed() const {
+    return m_seed;
+}
+
+uint64_t LinesEngine::randomState() const {
+    return m_random.state();
+}
+
+/**
+ * @brief LinesEngine::restoreRandom
+ * Восстанавливает зерно партии и текущее состояние генератора
+ */
+void LinesEngine::restoreRandom(uint64_t seed, uint64_t state) {
+    m_seed = seed;
+    m_random.setState(state);
+}
+
+/**
+ * @brief LinesEngine::spawned
+ * * @return ячейки, занятые последним ходом компьютера, в порядке размещения
+ */
+const std::vector<int>& LinesEngine::spawned() const {
+    return m_spawned;
+}
+
+/**
+ * @brief LinesEngine::setSpawned
+ * Запоминает ход компьютера, примененный изменениями TurnDelta, а не makeComputerMove,
+ * чтобы MoveJournal записал его фигуры
+ */
+void LinesEngine::setSpawned(const std::vector<int>& cells) {
+    m_spawned = cells;
+}
+
+/**
+ * @brief LinesEngine::newGame
+ * Начинает новую партию: пустое поле, нулевой счет и первый ход компьютера
+ * * @param seed - зерно генератора партии
+ */
+void LinesEngine::newGame(uint64_t seed) {
+    reset();
+    restoreRandom(seed, seed);
+    makeComputerMove();
+}
+
+/**
+ * @brief LinesEngine::replay
+ * Воспроизводит партию по зерну и последовательности ходов игрока
+ * * @return false - если какой-то из ходов недопустим
+ */
+bool LinesEngine::replay(uint64_t seed, const std::vector<Move>& moves) {
+    newGame(seed);
+    for (const Move& move : moves) {
+        if (!playTurn(move.from, move.to))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief LinesEngine::endTurn
+ * Заканчивает ход игрока: собирает линии через последнюю фигуру и делает ход компьютера
+ * * @param index - индекс ячейки последнего хода
+ */
+void LinesEngine::endTurn(int index) {
+    checkAndApplyWinLines(index);
+    makeComputerMove();
+}
+
+/**
+ * @brief LinesEngine::playTurn
+ * Полный ход: перемещение фигуры и его завершение
+ * * @return true - если ход был допустим
+ */
+bool LinesEngine::playTurn(int from, int to) {
+    if (!moveCell(from, to))
+        return false;
+    endTurn(to);
+    return true;
+}
+
+void LinesEngine::notifyCell(int index) {
+    if (m_listener)
+        m_listener->cellChanged(index);
+}
+
+void LinesEngine::notifyPlaced(int index, int idColor, int freePos) {
+    if (m_listener)
+        m_listener->cellPlaced(index, idColor, freePos);
+}
+
+void LinesEngine::notifyCleared(int index, int idColor) {
+    if (m_listener)
+        m_listener->cellCleared(index, idColor);
+}
@@ -0,0 +1,134 @@
+#ifndef LINESENGINE_H
+#define LINESENGINE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "splitmix64.h"
+
+/**
+ * Настраиваемые правила партии
+ */
+struct LinesRules {
+    int pointsForWin = 10;
+    int lengthWin    = 5;
+    int spawnCount   = 3;
+    int colorsCount  = 4;
+};
+
+/**
+ * Ход игрока: перемещение фигуры из from в to
+ */
+struct Move {
+    int from = -1;
+    int to   = -1;
+};
+
+/**
+ * Получатель изменений состояния движка (модель представления, хранилище)
+ */
+class LinesEngineListener {
+public:
+    virtual ~LinesEngineListener() {}
+
+    virtual void cellChanged(int index) = 0;
+    virtual void scoreChanged(int score) = 0;
+
+    /**
+     * Подробности изменений для истории ходов, в порядке выполнения: фигура размещена
+     * в свободную ячейку, стоявшую на позиции freePos массива свободных, либо снята с поля.
+     * Приходят только от ходов игрока и компьютера, не от восстановления и не от отмены
+     */
+    virtual void cellPlaced(int /*index*/, int /*idColor*/, int /*freePos*/) {}
+    virtual void cellCleared(int /*index*/, int /*idColor*/) {}
+};
+
+/**
+ * Правила игры без зависимостей от Qt и хранилища: перемещение фигур,
+ * сбор линий, ход компьютера и подсчет очков.
+ * Каждый экземпляр владеет собственным генератором, поэтому партия воспроизводится
+ * по зерну и ходам игрока.
+ * Поле может быть любым прямоугольником до MAX_SIDE x MAX_SIDE: create выбирает
+ * реализацию BasicLinesEngine, специализированную под размер, если он из числа частых
+ */
+class LinesEngine {
+public:
+    enum {
+        MAX_SIDE        = 64,
+        MAX_COLORS      = 7,
+        DEFAULT_ROWS    = 9,
+        DEFAULT_COLUMNS = 9
+    };
+
+    static std::unique_ptr<LinesEngine> create(int rows = DEFAULT_ROWS, int columns = DEFAULT_COLUMNS,
+                                               const LinesRules& rules = LinesRules());
+
+    virtual ~LinesEngine() {}
+    virtual std::unique_ptr<LinesEngine> clone() const = 0;
+
+    void setListener(LinesEngineListener* listener);
+
+    const LinesRules& rules() const;
+
+    int  score() const;
+    void setScore(int newScore);
+
+    uint64_t seed() const;
+    uint64_t randomState() const;
+    void     restoreRandom(uint64_t seed, uint64_t state);
+
+    const std::vector<int>& spawned() const;
+    void                    setSpawned(const std::vector<int>& cells);
+
+    virtual int rows() const = 0;
+    virtual int columns() const = 0;
+    virtual int cells() const = 0;
+
+    virtual bool isBusy(int index) const = 0;
+    virtual int  colorAt(int index) const = 0;
+    virtual int  freeCount() const = 0;
+    virtual int  freeCellAt(int n) const = 0;
+    virtual bool isFinal() const = 0;
+    virtual uint64_t hash() const = 0;
+
+    virtual void reset() = 0;
+    virtual void restoreCell(int index, int idColor) = 0;
+    virtual bool restoreFreeOrder(const int* cells, int count) = 0;
+    void newGame(uint64_t seed);
+    bool replay(uint64_t seed, const std::vector<Move>& moves);
+
+    virtual bool canMove(int from, int to) const = 0;
+    virtual bool moveCell(int from, int to) = 0;
+    virtual int  shortestPath(int from, int to, std::vector<int>& path) const = 0;
+    virtual bool moveAlong(const std::vector<int>& path) = 0;
+    void endTurn(int index);
+    bool playTurn(int from, int to);
+
+    // изменения для отмены и повтора хода: уведомляют cellChanged, но не cellPlaced и cellCleared
+    virtual void applyPlace(int index, int idColor) = 0;
+    virtual void applyClear(int index) = 0;
+    virtual void revertPlace(int index, int freePos) = 0;
+
+    virtual void makeComputerMove() = 0;
+    virtual int  checkAndApplyWinLines(int index) = 0;
+    virtual int  countLines(int minLength) const = 0;
+    virtual void legalMoves(std::vector<Move>& moves) const = 0;
+    virtual int  longestRunIfMoved(const Move& move) const = 0;
+
+protected:
+    explicit LinesEngine(const LinesRules& rules);
+
+    LinesRules           m_rules;
+    LinesEngineListener* m_listener {nullptr};
+    int                  m_score    {0};
+    uint64_t             m_seed     {0};
+    SplitMix64           m_random;
+    std::vector<int>     m_spawned;
+
+    void notifyCell(int index);
+    void notifyPlaced(int index, int idColor, int freePos);
+    void notifyCleared(int index, int idColor);
+};
+
+#endif // LINESENGINE_H
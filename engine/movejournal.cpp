@@ -0,0 +1,403 @@
+#include "movejournal.h"
+
+namespace {
+
+/**
+ * Последовательное чтение событий журнала с проверкой границ.
+ * Оборванное в конце событие считается концом журнала
+ */
+class JournalCursor {
+public:
+    JournalCursor(const uint8_t* data, size_t size, size_t offset = 0)
+        : m_data(data), m_size(size), m_offset(offset) {
+    }
+
+    size_t offset() const {
+        return m_offset;
+    }
+
+    bool readType(int& type) {
+        if (m_offset >= m_size)
+            return false;
+        type = m_data[m_offset++];
+        return true;
+    }
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && m_offset < m_size; shift += 7) {
+            uint8_t byte = m_data[m_offset++];
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    bool readInt(int& value) {
+        uint64_t raw;
+        if (!readVarint(raw))
+            return false;
+        value = static_cast<int>(raw);
+        return true;
+    }
+
+    /**
+     * @brief JournalCursor::skipPayload
+     * Пропускает данные события, не применяя их
+     */
+    bool skipPayload(int type) {
+        uint64_t value;
+        switch (type) {
+        case MoveJournal::EVENT_GAME:
+            return readVarint(value) && readVarint(value) && readVarint(value);
+        case MoveJournal::EVENT_MOVE:
+        case MoveJournal::EVENT_SPAWN:
+            return readVarint(value) && readVarint(value);
+        case MoveJournal::EVENT_UNDO:
+        case MoveJournal::EVENT_REDO:
+            return true;
+        case MoveJournal::EVENT_SNAPSHOT: {
+            uint64_t count;
+            if (!readVarint(value) || !readVarint(value) || !readVarint(value) || !readVarint(count))
+                return false;
+            for (uint64_t i = 0; i < count; ++i)
+                if (!readVarint(value) || !readVarint(value))
+                    return false;
+            if (!readVarint(count))
+                return false;
+            for (uint64_t i = 0; i < count; ++i)
+                if (!readVarint(value))
+                    return false;
+            return true;
+        }
+        }
+        return false;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t         m_size;
+    size_t         m_offset;
+};
+
+/**
+ * @brief restoreSnapshot
+ * Восстанавливает в движке состояние из события SNAPSHOT
+ * * @param moveNumber - заполняется номером хода снимка
+ */
+bool restoreSnapshot(JournalCursor& cursor, uint64_t seed, LinesEngine& engine, int& moveNumber) {
+    uint64_t number, score, state, count;
+    if (!cursor.readVarint(number) || !cursor.readVarint(score) ||
+            !cursor.readVarint(state) || !cursor.readVarint(count))
+        return false;
+    moveNumber = static_cast<int>(number);
+    engine.reset();
+    for (uint64_t i = 0; i < count; ++i) {
+        int index, color;
+        if (!cursor.readInt(index) || !cursor.readInt(color))
+            return false;
+        if (index < 0 || index >= engine.cells() || color < 0 || color > LinesEngine::MAX_COLORS)
+            return false;
+        engine.restoreCell(index, color);
+    }
+    if (!cursor.readVarint(count) || count > uint64_t(engine.cells()))
+        return false;
+    std::vector<int> free(count);
+    for (uint64_t i = 0; i < count; ++i)
+        if (!cursor.readInt(free[i]))
+            return false;
+    if (!engine.restoreFreeOrder(free.data(), int(count)))
+        return false;
+    engine.setScore(static_cast<int>(score));
+    engine.restoreRandom(seed, state);
+    return true;
+}
+
+} // namespace
+
+MoveJournal::MoveJournal(int snapshotInterval)
+    : m_snapshotInterval(snapshotInterval) {
+}
+
+/**
+ * @brief MoveJournal::beginGame
+ * Записывает начало партии: зерно, первый ход компьютера и начальный снимок.
+ * Вызывается после LinesEngine::newGame
+ */
+void MoveJournal::beginGame(const LinesEngine& engine) {
+    m_moveCount = 0;
+    m_gameStart = static_cast<long>(m_data.size());
+    m_data.push_back(EVENT_GAME);
+    writeVarint(engine.seed());
+    writeVarint(static_cast<uint64_t>(engine.rows()));
+    writeVarint(static_cast<uint64_t>(engine.columns()));
+    writeSpawns(engine);
+    recordSnapshot(engine);
+}
+
+/**
+ * @brief MoveJournal::recordTurn
+ * Записывает завершенный ход игрока и ответный ход компьютера
+ * * @param move - ход игрока, уже примененный к engine
+ */
+void MoveJournal::recordTurn(const LinesEngine& engine, const Move& move) {
+    ++m_moveCount;
+    m_data.push_back(EVENT_MOVE);
+    writeVarint(static_cast<uint64_t>(move.from));
+    writeVarint(static_cast<uint64_t>(move.to));
+    writeSpawns(engine);
+    if (m_snapshotInterval > 0 && m_moveCount % m_snapshotInterval == 0)
+        recordSnapshot(engine);
+}
+
+/**
+ * @brief MoveJournal::recordSnapshot
+ * Записывает полное состояние партии после текущего хода
+ */
+void MoveJournal::recordSnapshot(const LinesEngine& engine) {
+    m_data.push_back(EVENT_SNAPSHOT);
+    writeVarint(static_cast<uint64_t>(m_moveCount));
+    writeVarint(static_cast<uint64_t>(engine.score()));
+    writeVarint(engine.randomState());
+    writeVarint(static_cast<uint64_t>(engine.cells() - engine.freeCount()));
+    for (int index = 0; index < engine.cells(); ++index) {
+        if (!engine.isBusy(index))
+            continue;
+        writeVarint(static_cast<uint64_t>(index));
+        writeVarint(static_cast<uint64_t>(engine.colorAt(index)));
+    }
+    writeVarint(static_cast<uint64_t>(engine.freeCount()));
+    for (int n = 0; n < engine.freeCount(); ++n)
+        writeVarint(static_cast<uint64_t>(engine.freeCellAt(n)));
+}
+
+/**
+ * @brief MoveJournal::recordUndo
+ * Записывает отмену последнего хода и снимок поля после нее
+ */
+void MoveJournal::recordUndo(const LinesEngine& engine) {
+    if (m_moveCount > 0)
+        --m_moveCount;
+    m_data.push_back(EVENT_UNDO);
+    recordSnapshot(engine);
+}
+
+/**
+ * @brief MoveJournal::recordRedo
+ * Записывает повтор отмененного хода и снимок поля после него
+ */
+void MoveJournal::recordRedo(const LinesEngine& engine) {
+    ++m_moveCount;
+    m_data.push_back(EVENT_REDO);
+    recordSnapshot(engine);
+}
+
+int MoveJournal::moveCount() const {
+    return m_moveCount;
+}
+
+/**
+ * @brief MoveJournal::setMoveCount
+ * Продолжает нумерацию ходов партии, восстановленной из журнала
+ */
+void MoveJournal::setMoveCount(int moveCount) {
+    m_moveCount = moveCount;
+}
+
+const std::vector<uint8_t>& MoveJournal::data() const {
+    return m_data;
+}
+
+/**
+ * @brief MoveJournal::gameStart
+ * Позволяет хранилищу запомнить, где начинается последняя партия,
+ * и при восстановлении не читать журнал с начала
+ * * @return смещение события GAME последней партии в data(), либо -1, если его там нет
+ */
+long MoveJournal::gameStart() const {
+    return m_gameStart;
+}
+
+/**
+ * @brief MoveJournal::clearData
+ * Освобождает уже сохраненные байты, сохраняя нумерацию ходов
+ */
+void MoveJournal::clearData() {
+    m_data.clear();
+    m_gameStart = -1;
+}
+
+/**
+ * @brief MoveJournal::findGames
+ * * @return смещения начал всех партий в журнале
+ */
+std::vector<size_t> MoveJournal::findGames(const uint8_t* data, size_t size) {
+    std::vector<size_t> games;
+    JournalCursor cursor(data, size);
+    int type;
+    while (true) {
+        size_t offset = cursor.offset();
+        if (!cursor.readType(type) || !cursor.skipPayload(type))
+            break;
+        if (type == EVENT_GAME)
+            games.push_back(offset);
+    }
+    return games;
+}
+
+/**
+ * @brief MoveJournal::readGame
+ * Читает заголовок партии, чтобы создать движок нужного размера перед replay
+ * * @return false - если data не начинается с события GAME
+ */
+bool MoveJournal::readGame(const uint8_t* data, size_t size, uint64_t& seed, int& rows, int& columns) {
+    JournalCursor cursor(data, size);
+    int type;
+    return cursor.readType(type) && type == EVENT_GAME && cursor.readVarint(seed) &&
+            cursor.readInt(rows) && cursor.readInt(columns);
+}
+
+/**
+ * @brief MoveJournal::replay
+ * Перематывает партию, начинающуюся с data, до хода moveNumber без уведомлений,
+ * начиная с ближайшего предшествующего снимка. Фигуры компьютера сверяются с журналом.
+ * Если нужна история ходов, партия перематывается с начала и ходы записываются в history,
+ * отмены и повторы выполняются по ней, а снимки, не совпавшие с полем, очищают историю
+ * * @param moveNumber - номер хода; если он больше числа ходов, партия воспроизводится целиком
+ * * @param engine - движок без получателя изменений с размером поля из readGame
+ * * @param history - история ходов для заполнения, либо nullptr
+ * * @return номер достигнутого хода, либо -1, если журнал поврежден или не совпадает с правилами
+ */
+int MoveJournal::replay(const uint8_t* data, size_t size, int moveNumber, LinesEngine& engine,
+                        UndoStack* history) {
+    JournalCursor cursor(data, size);
+    int type;
+    uint64_t seed;
+    int rows, columns;
+    if (!cursor.readType(type) || type != EVENT_GAME || !cursor.readVarint(seed) ||
+            !cursor.readInt(rows) || !cursor.readInt(columns))
+        return -1;
+    if (rows != engine.rows() || columns != engine.columns())
+        return -1;
+
+    // первый проход: последний снимок не позже moveNumber, для истории - первый
+    size_t snapshotOffset = 0;
+    int snapshotMove = -1;
+    while (true) {
+        size_t offset = cursor.offset();
+        if (!cursor.readType(type) || type == EVENT_GAME)
+            break;
+        if (type == EVENT_SNAPSHOT) {
+            uint64_t number;
+            JournalCursor peek(data, size, cursor.offset());
+            if (!peek.readVarint(number))
+                break;
+            if (int(number) > moveNumber)
+                break;
+            snapshotOffset = offset;
+            snapshotMove = int(number);
+            if (history)
+                break;
+        }
+        if (!cursor.skipPayload(type))
+            break;
+    }
+    if (snapshotMove < 0)
+        return -1;
+
+    // второй проход: снимок и ходы после него
+    cursor = JournalCursor(data, size, snapshotOffset + 1);
+    if (!restoreSnapshot(cursor, seed, engine, snapshotMove))
+        return -1;
+    if (history) {
+        history->clear();
+        engine.setListener(history);
+    }
+    int reached = snapshotMove;
+    size_t spawnIndex = 0;
+    bool isValid = true;
+    bool isInTurn = false;   // последним прочитан ход или его появившиеся фигуры
+    while (isValid && reached < moveNumber) {
+        if (!cursor.readType(type) || type == EVENT_GAME)
+            break;
+        if (type == EVENT_MOVE) {
+            int from, to;
+            if (!cursor.readInt(from) || !cursor.readInt(to))
+                break;
+            if (history)
+                history->beginTurn(engine);
+            isValid = engine.playTurn(from, to);
+            if (history)
+                history->endTurn(engine);
+            ++reached;
+            spawnIndex = 0;
+            isInTurn = true;
+            continue;
+        } else if (type == EVENT_SPAWN) {
+            int index, color;
+            if (!cursor.readInt(index) || !cursor.readInt(color))
+                break;
+            isValid = isSpawnRecorded(engine, spawnIndex++, index, color);
+            continue;
+        } else if (type == EVENT_SNAPSHOT) {
+            // без истории поле после отмены и повтора берется из следующего за ними снимка
+            uint64_t hash = engine.hash();
+            int score = engine.score();
+            uint64_t state = engine.randomState();
+            int number;
+            if (!restoreSnapshot(cursor, seed, engine, number))
+                break;
+            if (history && (hash != engine.hash() || score != engine.score() ||
+                            state != engine.randomState()))
+                history->clear();
+            reached = number;
+        } else if (type == EVENT_UNDO) {
+            if (history && !history->undo(engine))
+                history->clear();
+        } else if (type == EVENT_REDO) {
+            if (history && !history->redo(engine))
+                history->clear();
+        } else {
+            isValid = false;
+        }
+        isInTurn = false;
+    }
+    // фигуры, появившиеся после последнего хода, записаны за ним: проверяются до следующего события
+    while (isValid && isInTurn) {
+        JournalCursor peek = cursor;
+        int index, color;
+        if (!peek.readType(type) || type != EVENT_SPAWN || !peek.readInt(index) || !peek.readInt(color))
+            break;
+        isValid = isSpawnRecorded(engine, spawnIndex++, index, color);
+        cursor = peek;
+    }
+    if (history)
+        engine.setListener(nullptr);
+    return isValid ? reached : -1;
+}
+
+/**
+ * @brief MoveJournal::isSpawnRecorded
+ * * @return true - если n-я фигура последнего хода компьютера совпадает с записанной
+ */
+bool MoveJournal::isSpawnRecorded(const LinesEngine& engine, size_t n, int index, int color) {
+    const std::vector<int>& spawned = engine.spawned();
+    return n < spawned.size() && spawned[n] == index && engine.colorAt(index) == color;
+}
+
+void MoveJournal::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        m_data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_data.push_back(static_cast<uint8_t>(value));
+}
+
+void MoveJournal::writeSpawns(const LinesEngine& engine) {
+    for (int index : engine.spawned()) {
+        m_data.push_back(EVENT_SPAWN);
+        writeVarint(static_cast<uint64_t>(index));
+        writeVarint(static_cast<uint64_t>(engine.colorAt(index)));
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef MOVEJOURNAL_H
+#define MOVEJOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "linesengine.h"
+#include "undostack.h"
+
+/**
+ * Журнал партий только на дописывание.
+ * Каждое событие - байт типа и числа в кодировке varint:
+ *   GAME     seed, rows, columns                      - начало партии
+ *   MOVE     from, to                                 - ход игрока
+ *   SPAWN    index, color                             - фигура хода компьютера
+ *   SNAPSHOT moveNumber, score, randomState,
+ *            busy, busy * (index, color),
+ *            free, free * index                       - полное состояние после хода moveNumber,
+ *                                                       включая порядок свободных ячеек
+ *   UNDO                                              - отмена последнего хода
+ *   REDO                                              - повтор отмененного хода
+ * Снимки пишутся в начале партии, каждые snapshotInterval ходов и при любом изменении
+ * поля не ходом игрока, в том числе после отмены и повтора,
+ * поэтому воспроизведение до хода N начинается с ближайшего снимка.
+ * В одном буфере может лежать сколько угодно партий подряд
+ */
+class MoveJournal {
+public:
+    enum EventType {
+        EVENT_GAME     = 1,
+        EVENT_MOVE     = 2,
+        EVENT_SPAWN    = 3,
+        EVENT_SNAPSHOT = 4,
+        EVENT_UNDO     = 5,
+        EVENT_REDO     = 6
+    };
+
+    explicit MoveJournal(int snapshotInterval = 32);
+
+    void beginGame(const LinesEngine& engine);
+    void recordTurn(const LinesEngine& engine, const Move& move);
+    void recordSnapshot(const LinesEngine& engine);
+    void recordUndo(const LinesEngine& engine);
+    void recordRedo(const LinesEngine& engine);
+
+    int  moveCount() const;
+    void setMoveCount(int moveCount);
+
+    const std::vector<uint8_t>& data() const;
+    long                        gameStart() const;
+    void                        clearData();
+
+    static std::vector<size_t> findGames(const uint8_t* data, size_t size);
+    static bool readGame(const uint8_t* data, size_t size, uint64_t& seed, int& rows, int& columns);
+    static int replay(const uint8_t* data, size_t size, int moveNumber, LinesEngine& engine,
+                      UndoStack* history = nullptr);
+
+private:
+    std::vector<uint8_t> m_data;
+    int                  m_snapshotInterval;
+    int                  m_moveCount {0};
+    long                 m_gameStart {-1};
+
+    void writeVarint(uint64_t value);
+    void writeSpawns(const LinesEngine& engine);
+
+    static bool isSpawnRecorded(const LinesEngine& engine, size_t n, int index, int color);
+};
+
+#endif // MOVEJOURNAL_H
@@ -0,0 +1,28 @@
+#include "movepolicy.h"
+
+bool RandomMovePolicy::chooseMove(const LinesEngine& engine, Move& move) {
+    engine.legalMoves(m_moves);
+    if (m_moves.empty())
+        return false;
+    move = m_moves[m_random.bounded(int(m_moves.size()))];
+    return true;
+}
+
+bool GreedyMovePolicy::chooseMove(const LinesEngine& engine, Move& move) {
+    engine.legalMoves(m_moves);
+    if (m_moves.empty())
+        return false;
+    int bestLength = 0;
+    m_best.clear();
+    for (const Move& candidate : m_moves) {
+        int length = engine.longestRunIfMoved(candidate);
+        if (length > bestLength) {
+            bestLength = length;
+            m_best.clear();
+        }
+        if (length == bestLength)
+            m_best.push_back(candidate);
+    }
+    move = m_best[m_random.bounded(int(m_best.size()))];
+    return true;
+}
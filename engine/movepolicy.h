@@ -0,0 +1,55 @@
+#ifndef MOVEPOLICY_H
+#define MOVEPOLICY_H
+
+#include <vector>
+
+#include "linesengine.h"
+#include "splitmix64.h"
+
+/**
+ * Стратегия выбора хода для автоматической игры
+ */
+class MovePolicy {
+public:
+    virtual ~MovePolicy() {}
+
+    void seed(uint64_t seed) {
+        m_random.setState(seed);
+    }
+
+    /**
+     * @brief MovePolicy::chooseMove
+     * * @param move - выбранный ход
+     * * @return false - если допустимых ходов нет
+     */
+    virtual bool chooseMove(const LinesEngine& engine, Move& move) = 0;
+
+protected:
+    SplitMix64 m_random;
+};
+
+/**
+ * Случайный допустимый ход
+ */
+class RandomMovePolicy : public MovePolicy {
+public:
+    bool chooseMove(const LinesEngine& engine, Move& move) override;
+
+private:
+    std::vector<Move> m_moves;
+};
+
+/**
+ * Жадный ход: максимизирует длину самой длинной одноцветной серии через целевую ячейку,
+ * среди равных выбирает случайно
+ */
+class GreedyMovePolicy : public MovePolicy {
+public:
+    bool chooseMove(const LinesEngine& engine, Move& move) override;
+
+private:
+    std::vector<Move> m_moves;
+    std::vector<Move> m_best;
+};
+
+#endif // MOVEPOLICY_H
@@ -0,0 +1,50 @@
+#ifndef SPLITMIX64_H
+#define SPLITMIX64_H
+
+#include <cstdint>
+
+/**
+ * Быстрый генератор SplitMix64 с 64-битным состоянием.
+ * Последовательность полностью определяется зерном, а состояние можно сохранить и восстановить
+ */
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed = 0)
+        : m_state(seed) {
+    }
+
+    uint64_t state() const {
+        return m_state;
+    }
+
+    void setState(uint64_t state) {
+        m_state = state;
+    }
+
+    uint64_t next() {
+        return mix(m_state += 0x9E3779B97F4A7C15ull);
+    }
+
+    /**
+     * @brief SplitMix64::mix
+     * Перемешивающая функция генератора: по разным входам дает независимые на вид 64-битные числа
+     */
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief SplitMix64::bounded
+     * * @return случайное число в диапазоне [0, limit)
+     */
+    int bounded(int limit) {
+        return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(limit)) >> 32);
+    }
+
+private:
+    uint64_t m_state;
+};
+
+#endif // SPLITMIX64_H
@@ -0,0 +1,136 @@
+#include "tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t    start;
+    uint64_t    end;
+};
+
+/**
+ * Кольцевой буфер одного потока. Пишет только владелец, поэтому запись без блокировок
+ */
+struct TraceRing {
+    int                   tid;
+    std::string           threadName;
+    std::atomic<uint64_t> written {0};
+    TraceEvent            events[Tracer::RING_CAPACITY];
+};
+
+std::mutex                              registryMutex;
+std::vector<std::unique_ptr<TraceRing>> registry;
+
+thread_local TraceRing*  localRing = nullptr;
+thread_local const char* localName = nullptr;
+
+TraceRing* currentRing() {
+    if (localRing)
+        return localRing;
+    std::unique_ptr<TraceRing> ring(new TraceRing());
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ring->tid = int(registry.size()) + 1;
+    if (localName)
+        ring->threadName = localName;
+    localRing = ring.get();
+    registry.push_back(std::move(ring));
+    return localRing;
+}
+
+/**
+ * @brief writeEscaped
+ * Записывает строку в JSON, экранируя кавычки, обратную косую черту и управляющие символы
+ */
+void writeEscaped(FILE* file, const char* text) {
+    for (; *text; ++text) {
+        unsigned char c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\')
+            std::fprintf(file, "\\%c", c);
+        else if (c < 0x20)
+            std::fprintf(file, "\\u%04x", c);
+        else
+            std::fputc(c, file);
+    }
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled(false);
+
+void Tracer::setEnabled(bool isEnabled) {
+    enabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const char* name) {
+    localName = name;
+    if (localRing) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        localRing->threadName = name;
+    }
+}
+
+/**
+ * @brief Tracer::now
+ * * @return монотонное время в наносекундах, всегда больше нуля
+ */
+uint64_t Tracer::now() {
+    uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch()).count());
+    return ns ? ns : 1;
+}
+
+void Tracer::record(const char* name, uint64_t start, uint64_t end) {
+    TraceRing* ring = currentRing();
+    uint64_t written = ring->written.load(std::memory_order_relaxed);
+    TraceEvent& event = ring->events[written % RING_CAPACITY];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    ring->written.store(written + 1, std::memory_order_release);
+}
+
+bool Tracer::writeChromeTrace(const std::string& fileName) {
+    FILE* file = std::fopen(fileName.c_str(), "w");
+    if (!file)
+        return false;
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    uint64_t origin = UINT64_MAX;
+    for (const std::unique_ptr<TraceRing>& ring : registry) {
+        uint64_t written = ring->written.load(std::memory_order_acquire);
+        uint64_t first = written > RING_CAPACITY ? written - RING_CAPACITY : 0;
+        for (uint64_t i = first; i < written; ++i)
+            origin = std::min(origin, ring->events[i % RING_CAPACITY].start);
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool isFirst = true;
+    for (const std::unique_ptr<TraceRing>& ring : registry) {
+        if (!ring->threadName.empty()) {
+            std::fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                               "\"args\":{\"name\":\"", isFirst ? "" : ",", ring->tid);
+            writeEscaped(file, ring->threadName.c_str());
+            std::fprintf(file, "\"}}");
+            isFirst = false;
+        }
+        uint64_t written = ring->written.load(std::memory_order_acquire);
+        uint64_t first = written > RING_CAPACITY ? written - RING_CAPACITY : 0;
+        for (uint64_t i = first; i < written; ++i) {
+            const TraceEvent& event = ring->events[i % RING_CAPACITY];
+            std::fprintf(file, "%s\n{\"name\":\"", isFirst ? "" : ",");
+            writeEscaped(file, event.name);
+            std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         ring->tid, (event.start - origin) / 1000.0, (event.end - event.start) / 1000.0);
+            isFirst = false;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,79 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Трассировка горячих участков: интервалы записываются в кольцевой буфер своего потока
+ * и выгружаются в формате Chrome trace-event (chrome://tracing, Perfetto).
+ * Пока трассировка выключена, интервал стоит одной проверки флага.
+ * Сборка с LINES_NO_TRACE убирает интервалы совсем
+ */
+class Tracer {
+public:
+    enum {
+        RING_CAPACITY = 1 << 16  // интервалов на поток, старые перезаписываются
+    };
+
+    static bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool isEnabled);
+
+    /**
+     * @brief Tracer::setThreadName
+     * Задает имя текущего потока в выгрузке
+     */
+    static void setThreadName(const char* name);
+
+    static uint64_t now();
+    static void     record(const char* name, uint64_t start, uint64_t end);
+
+    /**
+     * @brief Tracer::writeChromeTrace
+     * Выгружает интервалы всех потоков. Вызывается, когда трассируемые потоки остановлены
+     * * @return false - если файл не записан
+     */
+    static bool writeChromeTrace(const std::string& fileName);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+/**
+ * Интервал от создания до конца области видимости.
+ * name должен жить до выгрузки, обычно это строковый литерал
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : m_name(name),
+          m_start(Tracer::isEnabled() ? Tracer::now() : 0) {
+    }
+
+    ~TraceSpan() {
+        if (m_start)
+            Tracer::record(m_name, m_start, Tracer::now());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t    m_start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef LINES_NO_TRACE
+#define TRACE_SPAN(name)
+#else
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#endif
+
+#endif // TRACER_H
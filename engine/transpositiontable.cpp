@@ -0,0 +1,171 @@
+#include "transpositiontable.h"
+
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t megabytes, Replacement replacement)
+    : m_replacement(replacement) {
+    resize(megabytes);
+}
+
+/**
+ * @brief TranspositionTable::resize
+ * Заново выделяет таблицу, все записи теряются. Нельзя вызывать во время поиска
+ */
+void TranspositionTable::resize(size_t megabytes) {
+    size_t buckets = std::max<size_t>(1, megabytes * 1024 * 1024 / (2 * sizeof(Slot)));
+    size_t power = 1;
+    while (power * 2 <= buckets)
+        power *= 2;
+    m_slots.reset(new Slot[power * 2]);
+    m_bucketMask = power - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    const size_t count = capacity();
+    for (size_t i = 0; i < count; ++i) {
+        m_slots[i].check.store(0, std::memory_order_relaxed);
+        m_slots[i].data.store(0, std::memory_order_relaxed);
+    }
+    m_probes.store(0);
+    m_hits.store(0);
+}
+
+/**
+ * @brief TranspositionTable::newSearch
+ * Начинает новое поколение: записи прошлых поисков остаются доступны,
+ * но вытесняются в первую очередь
+ */
+void TranspositionTable::newSearch() {
+    ++m_generation;
+}
+
+size_t TranspositionTable::capacity() const {
+    return (m_bucketMask + 1) * 2;
+}
+
+size_t TranspositionTable::memoryBytes() const {
+    return capacity() * sizeof(Slot);
+}
+
+TranspositionTable::Replacement TranspositionTable::replacement() const {
+    return m_replacement;
+}
+
+void TranspositionTable::setReplacement(Replacement replacement) {
+    m_replacement = replacement;
+}
+
+/**
+ * @brief TranspositionTable::probe
+ * * @return true - если в таблице есть запись с ключом key
+ */
+bool TranspositionTable::probe(uint64_t key, TableEntry& entry) const {
+    m_probes.fetch_add(1, std::memory_order_relaxed);
+    const Slot* bucket = &m_slots[(key & m_bucketMask) * 2];
+    for (int i = 0; i < 2; ++i) {
+        uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key) {
+            unpack(data, entry);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief TranspositionTable::store
+ * Записывает значение узла. Запись с тем же ключом обновляется, если новая не мельче
+ * или старая осталась от прошлого поиска, иначе место выбирает политика замещения
+ * * @param best - лучший ход узла, from == to - хода нет
+ */
+void TranspositionTable::store(uint64_t key, int value, int depth, const Move& best) {
+    const unsigned generation = m_generation.load(std::memory_order_relaxed) & 0xFF;
+    const uint64_t data = pack(value, depth, generation, best);
+    Slot* bucket = &m_slots[(key & m_bucketMask) * 2];
+
+    uint64_t current[2];
+    for (int i = 0; i < 2; ++i) {
+        current[i] = bucket[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+        if ((check ^ current[i]) != key)
+            continue;
+        if (m_replacement == REPLACE_ALWAYS || depth >= depthOf(current[i]) ||
+                generationOf(current[i]) != generation) {
+            bucket[i].data.store(data, std::memory_order_relaxed);
+            bucket[i].check.store(key ^ data, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    auto isWeaker = [&](int i) {
+        return depth >= depthOf(current[i]) || generationOf(current[i]) != generation;
+    };
+    int target = -1;
+    switch (m_replacement) {
+    case REPLACE_ALWAYS:
+        target = int(key >> 63);
+        break;
+    case REPLACE_DEEPER:
+        // из двух записей вытесняется менее ценная: прошлого поиска, затем более мелкая
+        target = (generationOf(current[0]) != generation ||
+                  (generationOf(current[1]) == generation && depthOf(current[0]) <= depthOf(current[1])))
+                ? 0 : 1;
+        if (!isWeaker(target))
+            target = -1;
+        break;
+    case REPLACE_TWO_TIER:
+        target = isWeaker(0) ? 0 : 1;
+        break;
+    }
+    if (target < 0)
+        return;
+    bucket[target].data.store(data, std::memory_order_relaxed);
+    bucket[target].check.store(key ^ data, std::memory_order_relaxed);
+}
+
+uint64_t TranspositionTable::probes() const {
+    return m_probes.load();
+}
+
+uint64_t TranspositionTable::hits() const {
+    return m_hits.load();
+}
+
+/**
+ * @brief TranspositionTable::pack
+ * Раскладка слова данных: значение 24 бита, глубина 8, поколение 8, откуда 12, куда 12
+ */
+uint64_t TranspositionTable::pack(int value, int depth, unsigned generation, const Move& best) {
+    const int limit = (1 << (VALUE_BITS - 1)) - 1;
+    value = std::max(-limit, std::min(limit, value));
+    uint64_t from = best.from >= 0 ? uint64_t(best.from) : 0;
+    uint64_t to = best.from >= 0 ? uint64_t(best.to) : 0;
+    return (uint64_t(uint32_t(value) & ((1u << VALUE_BITS) - 1)) << 40) |
+            (uint64_t(std::min(depth, int(DEPTH_MAX))) << 32) |
+            (uint64_t(generation & 0xFF) << 24) |
+            ((from & 0xFFF) << 12) |
+            (to & 0xFFF);
+}
+
+void TranspositionTable::unpack(uint64_t data, TableEntry& entry) {
+    int value = int((data >> 40) & ((1u << VALUE_BITS) - 1));
+    if (value & (1 << (VALUE_BITS - 1)))
+        value -= 1 << VALUE_BITS;
+    entry.value = value;
+    entry.depth = depthOf(data);
+    int from = int((data >> 12) & 0xFFF);
+    int to = int(data & 0xFFF);
+    entry.best.from = from != to ? from : -1;
+    entry.best.to = from != to ? to : -1;
+}
+
+int TranspositionTable::depthOf(uint64_t data) {
+    return int((data >> 32) & 0xFF);
+}
+
+unsigned TranspositionTable::generationOf(uint64_t data) {
+    return unsigned((data >> 24) & 0xFF);
+}
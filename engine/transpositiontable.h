@@ -0,0 +1,79 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "linesengine.h"
+
+/**
+ * Прочитанная запись таблицы
+ */
+struct TableEntry {
+    int  value = 0;
+    int  depth = 0;
+    Move best;
+};
+
+/**
+ * Таблица транспозиций фиксированного размера без блокировок.
+ * Запись - два 64-битных слова: данные и ключ, сложенный по XOR с данными.
+ * Запись, разорванная одновременной записью из двух потоков, не проходит проверку ключа
+ * и читается как промах, поэтому мьютексы не нужны.
+ * Таблица разбита на корзины по две записи, замещение задается политикой
+ */
+class TranspositionTable {
+public:
+    enum Replacement {
+        REPLACE_ALWAYS,   // новая запись всегда вытесняет старую
+        REPLACE_DEEPER,   // вытесняется запись меньшей глубины или прошлого поиска
+        REPLACE_TWO_TIER  // первая запись корзины - по глубине, вторая - всегда
+    };
+
+    enum {
+        VALUE_BITS = 24,
+        DEPTH_MAX  = 255
+    };
+
+    /**
+     * @param megabytes - объем памяти таблицы, округляется вниз до степени двойки записей
+     */
+    explicit TranspositionTable(size_t megabytes = 16, Replacement replacement = REPLACE_TWO_TIER);
+
+    void   resize(size_t megabytes);
+    void   clear();
+    void   newSearch();
+    size_t capacity() const;
+    size_t memoryBytes() const;
+
+    Replacement replacement() const;
+    void        setReplacement(Replacement replacement);
+
+    bool probe(uint64_t key, TableEntry& entry) const;
+    void store(uint64_t key, int value, int depth, const Move& best);
+
+    uint64_t probes() const;
+    uint64_t hits() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]>       m_slots;
+    size_t                        m_bucketMask  {0};
+    Replacement                   m_replacement;
+    std::atomic<unsigned>         m_generation  {0};
+    mutable std::atomic<uint64_t> m_probes      {0};
+    mutable std::atomic<uint64_t> m_hits        {0};
+
+    static uint64_t pack(int value, int depth, unsigned generation, const Move& best);
+    static void     unpack(uint64_t data, TableEntry& entry);
+    static int      depthOf(uint64_t data);
+    static unsigned generationOf(uint64_t data);
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,254 @@
+#include "undostack.h"
+
+#include <algorithm>
+
+#include "tracer.h"
+
+UndoStack::UndoStack(size_t budgetBytes)
+    : m_budget(budgetBytes) {
+}
+
+/**
+ * @brief UndoStack::setBudget
+ * Задает наибольший объем истории в байтах и сразу отбрасывает лишние старые ходы
+ */
+void UndoStack::setBudget(size_t budgetBytes) {
+    m_budget = budgetBytes;
+    fitBudget();
+}
+
+size_t UndoStack::budget() const {
+    return m_budget;
+}
+
+/**
+ * @brief UndoStack::memoryUsage
+ * * @return объем хранимой истории в байтах
+ */
+size_t UndoStack::memoryUsage() const {
+    return m_changes.size() * sizeof(uint32_t) + m_turns.size() * sizeof(Turn);
+}
+
+void UndoStack::clear() {
+    m_changes.clear();
+    m_turns.clear();
+    m_dropped = 0;
+    m_applied = 0;
+    m_isRecording = false;
+}
+
+/**
+ * @brief UndoStack::beginTurn
+ * Начинает запись хода. Ходы, отмененные до этого, больше нельзя повторить
+ */
+void UndoStack::beginTurn(const LinesEngine& engine) {
+    dropRedo();
+    m_pending.randomBefore = engine.randomState();
+    m_pending.scoreBefore = engine.score();
+    m_pending.first = m_dropped + m_changes.size();
+    m_pending.count = 0;
+    m_isRecording = true;
+}
+
+/**
+ * @brief UndoStack::endTurn
+ * Заканчивает запись хода после ответного хода компьютера
+ */
+void UndoStack::endTurn(const LinesEngine& engine) {
+    if (!m_isRecording)
+        return;
+    m_isRecording = false;
+    m_pending.randomAfter = engine.randomState();
+    m_pending.scoreAfter = engine.score();
+    m_turns.push_back(m_pending);
+    m_applied = m_turns.size();
+    fitBudget();
+}
+
+/**
+ * @brief UndoStack::abortTurn
+ * Прерывает запись хода: обращает уже записанные изменения в обратном порядке
+ * и возвращает счет и состояние генератора, как будто ход не начинался.
+ * Отмененные до beginTurn ходы при этом не возвращаются
+ */
+void UndoStack::abortTurn(LinesEngine& engine) {
+    if (!m_isRecording)
+        return;
+    m_isRecording = false;
+    const size_t begin = size_t(m_pending.first - m_dropped);
+    for (size_t i = m_changes.size(); i-- > begin; )
+        revertChange(engine, m_changes[i]);
+    m_changes.erase(m_changes.begin() + begin, m_changes.end());
+    engine.setScore(m_pending.scoreBefore);
+    engine.restoreRandom(engine.seed(), m_pending.randomBefore);
+}
+
+bool UndoStack::isRecording() const {
+    return m_isRecording;
+}
+
+/**
+ * @brief UndoStack::recordedChanges
+ * * @return количество изменений, записанных в текущий ход
+ */
+int UndoStack::recordedChanges() const {
+    return m_isRecording ? int(m_pending.count) : 0;
+}
+
+/**
+ * @brief UndoStack::lastTurn
+ * Копирует последний сделанный ход, например чтобы перенести его на другой движок
+ * * @return false - если ходов нет
+ */
+bool UndoStack::lastTurn(TurnDelta& delta) const {
+    if (m_isRecording || m_applied == 0)
+        return false;
+    const Turn& turn = m_turns[m_applied - 1];
+    const size_t begin = size_t(turn.first - m_dropped);
+    delta.changes.assign(m_changes.begin() + begin, m_changes.begin() + begin + turn.count);
+    delta.moveChanges = 0;
+    delta.spawned.clear();
+    delta.randomBefore = turn.randomBefore;
+    delta.randomAfter = turn.randomAfter;
+    delta.scoreBefore = turn.scoreBefore;
+    delta.scoreAfter = turn.scoreAfter;
+    return true;
+}
+
+/**
+ * @brief UndoStack::applyChanges
+ * Применяет к движку изменения delta с номерами [begin, end) так же, как повтор хода,
+ * и записывает их в текущий ход. Счет, генератор и ход компьютера (setSpawned)
+ * после хода выставляет вызывающий до endTurn. Ход может применяться по частям: перемещение, затем ответ компьютера
+ */
+void UndoStack::applyChanges(LinesEngine& engine, const TurnDelta& delta, size_t begin, size_t end) {
+    end = std::min(end, delta.changes.size());
+    for (size_t i = begin; i < end; ++i) {
+        uint32_t change = delta.changes[i];
+        int index = int(change & FIELD_MASK);
+        if (change & PLACED_FLAG)
+            engine.applyPlace(index, int((change >> COLOR_SHIFT) & COLOR_MASK));
+        else
+            engine.applyClear(index);
+        if (!m_isRecording)
+            continue;
+        m_changes.push_back(change);
+        ++m_pending.count;
+    }
+}
+
+bool UndoStack::canUndo() const {
+    return !m_isRecording && m_applied > 0;
+}
+
+bool UndoStack::canRedo() const {
+    return !m_isRecording && m_applied < m_turns.size();
+}
+
+int UndoStack::undoCount() const {
+    return int(m_applied);
+}
+
+int UndoStack::redoCount() const {
+    return int(m_turns.size() - m_applied);
+}
+
+/**
+ * @brief UndoStack::undo
+ * Отменяет последний ход: обращает его изменения в обратном порядке,
+ * возвращает счет и состояние генератора
+ * * @return false - если отменять нечего
+ */
+bool UndoStack::undo(LinesEngine& engine) {
+    TRACE_SPAN("UndoStack::undo");
+    if (!canUndo())
+        return false;
+    const Turn& turn = m_turns[m_applied - 1];
+    const size_t begin = size_t(turn.first - m_dropped);
+    for (size_t i = begin + turn.count; i-- > begin; )
+        revertChange(engine, m_changes[i]);
+    engine.setScore(turn.scoreBefore);
+    engine.restoreRandom(engine.seed(), turn.randomBefore);
+    --m_applied;
+    return true;
+}
+
+/**
+ * @brief UndoStack::redo
+ * Повторяет последний отмененный ход
+ * * @return false - если повторять нечего
+ */
+bool UndoStack::redo(LinesEngine& engine) {
+    TRACE_SPAN("UndoStack::redo");
+    if (!canRedo())
+        return false;
+    const Turn& turn = m_turns[m_applied];
+    const size_t begin = size_t(turn.first - m_dropped);
+    for (size_t i = begin; i < begin + turn.count; ++i) {
+        uint32_t change = m_changes[i];
+        int index = int(change & FIELD_MASK);
+        if (change & PLACED_FLAG)
+            engine.applyPlace(index, int((change >> COLOR_SHIFT) & COLOR_MASK));
+        else
+            engine.applyClear(index);
+    }
+    engine.setScore(turn.scoreAfter);
+    engine.restoreRandom(engine.seed(), turn.randomAfter);
+    ++m_applied;
+    return true;
+}
+
+void UndoStack::cellPlaced(int index, int idColor, int freePos) {
+    if (!m_isRecording)
+        return;
+    m_changes.push_back(PLACED_FLAG | uint32_t(index & FIELD_MASK) |
+                        (uint32_t(idColor & COLOR_MASK) << COLOR_SHIFT) |
+                        (uint32_t(freePos & FIELD_MASK) << POSITION_SHIFT));
+    ++m_pending.count;
+}
+
+void UndoStack::cellCleared(int index, int idColor) {
+    if (!m_isRecording)
+        return;
+    m_changes.push_back(uint32_t(index & FIELD_MASK) | (uint32_t(idColor & COLOR_MASK) << COLOR_SHIFT));
+    ++m_pending.count;
+}
+
+/**
+ * @brief UndoStack::dropRedo
+ * Отбрасывает отмененные ходы с конца истории
+ */
+void UndoStack::dropRedo() {
+    while (m_turns.size() > m_applied) {
+        m_changes.erase(m_changes.end() - m_turns.back().count, m_changes.end());
+        m_turns.pop_back();
+    }
+}
+
+/**
+ * @brief UndoStack::fitBudget
+ * Отбрасывает самые старые ходы, пока история не уложится в бюджет.
+ * Последний ход остается всегда
+ */
+void UndoStack::fitBudget() {
+    while (memoryUsage() > m_budget && m_turns.size() > 1 && m_applied > 0) {
+        const Turn& oldest = m_turns.front();
+        m_changes.erase(m_changes.begin(), m_changes.begin() + oldest.count);
+        m_dropped += oldest.count;
+        m_turns.pop_front();
+        --m_applied;
+    }
+}
+
+/**
+ * @brief UndoStack::revertChange
+ * Обращает одно изменение: размещенная фигура снимается с возвратом ячейки
+ * на прежнюю позицию в массиве свободных, снятая - размещается снова
+ */
+void UndoStack::revertChange(LinesEngine& engine, uint32_t change) {
+    int index = int(change & FIELD_MASK);
+    if (change & PLACED_FLAG)
+        engine.revertPlace(index, int((change >> POSITION_SHIFT) & FIELD_MASK));
+    else
+        engine.applyPlace(index, int((change >> COLOR_SHIFT) & COLOR_MASK));
+}
@@ -0,0 +1,108 @@
+#ifndef UNDOSTACK_H
+#define UNDOSTACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "linesengine.h"
+
+/**
+ * Изменения одного хода в формате истории, в порядке выполнения, со счетом и состоянием
+ * генератора до и после хода. Так ход, разыгранный на копии движка (в другом потоке),
+ * переносится на исходный движок без повторного розыгрыша: UndoStack::applyChanges.
+ * Ячейки хода компьютера нужны журналу ходов и не восстанавливаются из изменений,
+ * потому что линия, собранная появившейся фигурой, сразу ее снимает
+ */
+struct TurnDelta {
+    std::vector<uint32_t> changes;
+    std::vector<int>      spawned;            // LinesEngine::spawned после хода
+    size_t                moveChanges  {0};   // первые изменения - перемещение фигуры игрока
+    uint64_t              randomBefore {0};
+    uint64_t              randomAfter  {0};
+    int32_t               scoreBefore  {0};
+    int32_t               scoreAfter   {0};
+};
+
+/**
+ * История ходов для отмены и повтора.
+ * Ход хранится не копией поля, а списком изменений в порядке выполнения:
+ * фигура размещена (ячейка, цвет, позиция в массиве свободных) или снята (ячейка, цвет),
+ * по 4 байта на изменение, плюс счет и состояние генератора до и после хода.
+ * Отмена применяет обратные изменения в обратном порядке и восстанавливает в том числе
+ * порядок свободных ячеек, от которого зависят следующие ходы компьютера.
+ * Поэтому отмена и повтор стоят столько, сколько изменений в ходе, независимо от размера поля.
+ * Объем истории ограничен бюджетом в байтах: при превышении отбрасываются самые старые ходы.
+ * Изменения записываются, пока история назначена получателем изменений движка
+ * (или получает их от него) между beginTurn и endTurn
+ */
+class UndoStack : public LinesEngineListener {
+public:
+    enum {
+        DEFAULT_BUDGET = 256 * 1024
+    };
+
+    explicit UndoStack(size_t budgetBytes = DEFAULT_BUDGET);
+
+    void   setBudget(size_t budgetBytes);
+    size_t budget() const;
+    size_t memoryUsage() const;
+
+    void clear();
+    void beginTurn(const LinesEngine& engine);
+    void endTurn(const LinesEngine& engine);
+    void abortTurn(LinesEngine& engine);
+    bool isRecording() const;
+    int  recordedChanges() const;
+
+    bool lastTurn(TurnDelta& delta) const;
+    void applyChanges(LinesEngine& engine, const TurnDelta& delta, size_t begin, size_t end);
+
+    bool canUndo() const;
+    bool canRedo() const;
+    int  undoCount() const;
+    int  redoCount() const;
+
+    bool undo(LinesEngine& engine);
+    bool redo(LinesEngine& engine);
+
+    void cellChanged(int /*index*/) override {}
+    void scoreChanged(int /*score*/) override {}
+    void cellPlaced(int index, int idColor, int freePos) override;
+    void cellCleared(int index, int idColor) override;
+
+private:
+    struct Turn {
+        uint64_t randomBefore;
+        uint64_t randomAfter;
+        uint64_t first;        // сквозной номер первого изменения хода
+        int32_t  scoreBefore;
+        int32_t  scoreAfter;
+        uint32_t count;
+    };
+
+    // изменение: ячейка - биты 0-11, цвет - 12-14, позиция свободной - 15-26, размещение - 31
+    enum : uint32_t {
+        COLOR_SHIFT    = 12,
+        POSITION_SHIFT = 15,
+        FIELD_MASK     = 0xFFF,
+        COLOR_MASK     = 0x7,
+        PLACED_FLAG    = 0x80000000u
+    };
+
+    std::deque<uint32_t> m_changes;
+    std::deque<Turn>     m_turns;
+    uint64_t             m_dropped {0};  // сквозной номер первого хранимого изменения
+    size_t               m_applied {0};  // ходов до текущей позиции, остальные - для повтора
+    size_t               m_budget;
+    bool                 m_isRecording {false};
+    Turn                 m_pending {};
+
+    void dropRedo();
+    void fitBudget();
+
+    static void revertChange(LinesEngine& engine, uint32_t change);
+};
+
+#endif // UNDOSTACK_H
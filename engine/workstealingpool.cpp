@@ -0,0 +1,137 @@
+#include "workstealingpool.h"
+
+#include <algorithm>
+
+#include "tracer.h"
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    if (threads <= 0)
+        threads = std::max(1, int(std::thread::hardware_concurrency()));
+    // последняя очередь общая для всех внешних потоков, вызвавших parallelFor
+    for (int i = 0; i <= threads; ++i)
+        m_queues.emplace_back(new Queue());
+    for (int i = 0; i < threads; ++i)
+        m_threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+int WorkStealingPool::threadCount() const {
+    return int(m_threads.size());
+}
+
+/**
+ * @brief WorkStealingPool::parallelFor
+ * Вызывает body для непересекающихся поддиапазонов [begin, end) не длиннее grain
+ * и возвращается, когда весь диапазон обработан
+ */
+void WorkStealingPool::parallelFor(int begin, int end, int grain, const RangeBody& body) {
+    if (begin >= end)
+        return;
+    Job job;
+    job.body = &body;
+    job.grain = std::max(1, grain);
+    job.remaining.store(end - begin);
+
+    const int slot = externalSlot();
+    ++m_activeJobs;
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_all();
+
+    Range range;
+    range.job = &job;
+    range.begin = begin;
+    range.end = end;
+    runRange(slot, range);
+    while (job.remaining.load(std::memory_order_acquire) > 0) {
+        if (takeRange(slot, range))
+            runRange(slot, range);
+        else
+            std::this_thread::yield();
+    }
+    --m_activeJobs;
+}
+
+/**
+ * @brief WorkStealingPool::workerLoop
+ * Выполняет работу из своей очереди, при ее отсутствии крадет из чужих,
+ * а когда активных циклов нет - засыпает
+ */
+void WorkStealingPool::workerLoop(int slot) {
+    Tracer::setThreadName("pool worker");
+    Range range;
+    while (true) {
+        if (takeRange(slot, range)) {
+            runRange(slot, range);
+            continue;
+        }
+        if (m_activeJobs.load() > 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_activeJobs.load() > 0; });
+        if (m_stop)
+            return;
+    }
+}
+
+/**
+ * @brief WorkStealingPool::takeRange
+ * Берет последний кусок своей очереди, иначе первый кусок чужой
+ * * @return false - если работы нет ни в одной очереди
+ */
+bool WorkStealingPool::takeRange(int slot, Range& range) {
+    {
+        Queue& own = *m_queues[slot];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.ranges.empty()) {
+            range = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+    const int count = int(m_queues.size());
+    for (int i = 1; i < count; ++i) {
+        Queue& victim = *m_queues[(slot + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief WorkStealingPool::runRange
+ * Откладывает правые половины диапазона в свою очередь и выполняет оставшийся кусок
+ */
+void WorkStealingPool::runRange(int slot, Range range) {
+    Job* job = range.job;
+    while (range.end - range.begin > job->grain) {
+        Range right = range;
+        right.begin = range.begin + (range.end - range.begin) / 2;
+        range.end = right.begin;
+        Queue& own = *m_queues[slot];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.ranges.push_back(right);
+    }
+    (*job->body)(range.begin, range.end);
+    job->remaining.fetch_sub(range.end - range.begin, std::memory_order_release);
+}
+
+int WorkStealingPool::externalSlot() const {
+    return int(m_queues.size()) - 1;
+}
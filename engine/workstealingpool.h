@@ -0,0 +1,69 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Пул потоков с кражей работы для параллельных циклов.
+ * Диапазон делится пополам до размера grain: правая половина кладется в хвост очереди
+ * своего потока, левая выполняется сразу. Свободный поток забирает работу из головы
+ * чужой очереди, то есть самый крупный из отложенных кусков.
+ * Вызывающий поток тоже выполняет работу, пока цикл не закончится.
+ * parallelFor можно вызывать одновременно из нескольких потоков
+ */
+class WorkStealingPool {
+public:
+    typedef std::function<void(int begin, int end)> RangeBody;
+
+    /**
+     * @param threads - количество рабочих потоков, 0 - по числу ядер
+     */
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int threadCount() const;
+
+    void parallelFor(int begin, int end, int grain, const RangeBody& body);
+
+private:
+    struct Job {
+        const RangeBody* body;
+        int              grain;
+        std::atomic<int> remaining;
+    };
+
+    struct Range {
+        Job* job;
+        int  begin;
+        int  end;
+    };
+
+    struct Queue {
+        std::mutex        mutex;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread>            m_threads;
+    std::atomic<int>                    m_activeJobs {0};
+    std::mutex                          m_sleepMutex;
+    std::condition_variable             m_wake;
+    bool                                m_stop       {false};
+
+    void workerLoop(int slot);
+    bool takeRange(int slot, Range& range);
+    void runRange(int slot, Range range);
+    int  externalSlot() const;
+};
+
+#endif // WORKSTEALINGPOOL_H
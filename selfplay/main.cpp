@@ -0,0 +1,660 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batchengine.h"
+#include "expectimaxsearch.h"
+#include "hintsearch.h"
+#include "linescan.h"
+#include "linesengine.h"
+#include "movejournal.h"
+#include "movepolicy.h"
+#include "tracer.h"
+#include "transpositiontable.h"
+#include "undostack.h"
+#include "workstealingpool.h"
+
+namespace {
+
+struct Options {
+    long        games   = 1000;
+    int         threads = 0;
+    std::string policy  = "greedy";
+    uint64_t    seed    = 0;
+    int         rows    = LinesEngine::DEFAULT_ROWS;
+    int         columns = LinesEngine::DEFAULT_COLUMNS;
+    int         budget  = 50;
+    int         searchThreads = 0;
+    int         tableMb = 64;
+    int         batch   = 0;
+    bool        verify  = false;
+    bool        verifyTurns = false;
+    TranspositionTable::Replacement replacement = TranspositionTable::REPLACE_TWO_TIER;
+    ExpectimaxOptions analysis;
+    std::string journal;
+    std::string replay;
+    std::string trace;
+    std::string scanKernel;
+    LinesRules  rules;
+};
+
+/**
+ * Общий файл журнала: каждая партия дописывается целиком под мьютексом
+ */
+struct JournalSink {
+    std::ofstream file;
+    std::mutex    mutex;
+};
+
+struct GameResult {
+    int      score;
+    uint64_t seed;
+
+    bool operator<(const GameResult& other) const {
+        return score < other.score;
+    }
+};
+
+struct WorkerStats {
+    std::vector<GameResult> results;
+    long                    turns = 0;
+};
+
+void printUsage(const char* name) {
+    std::printf("Usage: %s [--games N] [--threads N] [--policy random|greedy|hint|expectimax]\n"
+                "          [--seed N] [--rows N] [--columns N] [--budget MS] [--search-threads N]\n"
+                "          [--depth N] [--beam N] [--samples N] [--table-mb N]\n"
+                "          [--replace always|deeper|two-tier] [--trace FILE]\n"
+                "          [--scan-kernel portable|sse2|avx2] [--batch N] [--verify] [--verify-turns]\n"
+                "          [--points N] [--length N] [--spawn N] [--colors N] [--journal FILE]\n"
+                "       %s --replay FILE [--points N] [--length N] [--spawn N] [--colors N]\n"
+                "Game i is played with seed + i, so a single game is reproduced with\n"
+                "--games 1 --seed <game seed>. --journal records every game as a move journal,\n"
+                "--replay fast-forwards every game of a journal to its end.\n"
+                "The hint policy searches every move in parallel within --budget milliseconds\n"
+                "(0 - no limit) and plays one game at a time unless --threads is given.\n"
+                "The expectimax policy looks --depth moves ahead with --samples spawn outcomes\n"
+                "per chance node and a --table-mb transposition table.\n"
+                "--batch N plays the random policy on N boards per thread in lockstep with\n"
+                "the batch engine; --verify plays the same games on the batch engine and\n"
+                "on the regular engine and compares the boards after every turn.\n"
+                "--verify-turns plays the random or greedy policy the way the application does:\n"
+                "each turn is resolved on a copy, applied back as a delta in two phases,\n"
+                "sometimes aborted after the first one, and compared with playTurn, undo and redo.\n"
+                "--trace writes a Chrome trace-event JSON file of engine spans.\n"
+                "--scan-kernel forces the whole-board line scan implementation\n"
+                "(default - the best one the CPU supports).\n", name, name);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!std::strcmp(arg, "--help"))
+            return false;
+        if (!std::strcmp(arg, "--verify")) {
+            options.verify = true;
+            continue;
+        }
+        if (!std::strcmp(arg, "--verify-turns")) {
+            options.verifyTurns = true;
+            continue;
+        }
+        if (!value)
+            return false;
+        if (!std::strcmp(arg, "--games"))
+            options.games = std::atol(value);
+        else if (!std::strcmp(arg, "--threads"))
+            options.threads = std::atoi(value);
+        else if (!std::strcmp(arg, "--policy"))
+            options.policy = value;
+        else if (!std::strcmp(arg, "--seed"))
+            options.seed = std::strtoull(value, nullptr, 10);
+        else if (!std::strcmp(arg, "--rows"))
+            options.rows = std::atoi(value);
+        else if (!std::strcmp(arg, "--columns"))
+            options.columns = std::atoi(value);
+        else if (!std::strcmp(arg, "--budget"))
+            options.budget = std::atoi(value);
+        else if (!std::strcmp(arg, "--search-threads"))
+            options.searchThreads = std::atoi(value);
+        else if (!std::strcmp(arg, "--depth"))
+            options.analysis.depth = std::atoi(value);
+        else if (!std::strcmp(arg, "--beam"))
+            options.analysis.beamWidth = std::atoi(value);
+        else if (!std::strcmp(arg, "--samples"))
+            options.analysis.samples = std::atoi(value);
+        else if (!std::strcmp(arg, "--batch"))
+            options.batch = std::atoi(value);
+        else if (!std::strcmp(arg, "--table-mb"))
+            options.tableMb = std::atoi(value);
+        else if (!std::strcmp(arg, "--replace") && !std::strcmp(value, "always"))
+            options.replacement = TranspositionTable::REPLACE_ALWAYS;
+        else if (!std::strcmp(arg, "--replace") && !std::strcmp(value, "deeper"))
+            options.replacement = TranspositionTable::REPLACE_DEEPER;
+        else if (!std::strcmp(arg, "--replace") && !std::strcmp(value, "two-tier"))
+            options.replacement = TranspositionTable::REPLACE_TWO_TIER;
+        else if (!std::strcmp(arg, "--points"))
+            options.rules.pointsForWin = std::atoi(value);
+        else if (!std::strcmp(arg, "--length"))
+            options.rules.lengthWin = std::atoi(value);
+        else if (!std::strcmp(arg, "--spawn"))
+            options.rules.spawnCount = std::atoi(value);
+        else if (!std::strcmp(arg, "--colors"))
+            options.rules.colorsCount = std::atoi(value);
+        else if (!std::strcmp(arg, "--journal"))
+            options.journal = value;
+        else if (!std::strcmp(arg, "--replay"))
+            options.replay = value;
+        else if (!std::strcmp(arg, "--trace"))
+            options.trace = value;
+        else if (!std::strcmp(arg, "--scan-kernel"))
+            options.scanKernel = value;
+        else
+            return false;
+        ++i;
+    }
+    options.analysis.budgetMs = options.budget;
+    return options.games > 0 && options.budget >= 0 && options.tableMb > 0 &&
+            options.batch >= 0 &&
+            (options.batch == 0 || options.verify || (options.policy == "random" && options.journal.empty())) &&
+            (!options.verifyTurns || options.policy == "random" || options.policy == "greedy") &&
+            options.analysis.depth >= 1 && options.analysis.depth <= TranspositionTable::DEPTH_MAX &&
+            (options.policy == "random" || options.policy == "greedy" || options.policy == "hint" ||
+             options.policy == "expectimax") &&
+            options.rows >= 1 && options.rows <= LinesEngine::MAX_SIDE &&
+            options.columns >= 1 && options.columns <= LinesEngine::MAX_SIDE;
+}
+
+std::unique_ptr<MovePolicy> createPolicy(const Options& options, WorkStealingPool* pool,
+                                         TranspositionTable* table) {
+    const std::string& name = options.policy;
+    if (name == "random")
+        return std::unique_ptr<MovePolicy>(new RandomMovePolicy());
+    if (name == "hint")
+        return std::unique_ptr<MovePolicy>(new HintMovePolicy(*pool, options.budget));
+    if (name == "expectimax")
+        return std::unique_ptr<MovePolicy>(new ExpectimaxMovePolicy(*pool, *table, options.analysis));
+    return std::unique_ptr<MovePolicy>(new GreedyMovePolicy());
+}
+
+/**
+ * @brief playGames
+ * Играет партии, пока общий счетчик не достигнет options.games.
+ * Зерно партии зависит только от ее номера, поэтому результат не зависит от распределения по потокам
+ */
+void playGames(const Options& options, std::atomic<long>& nextGame, WorkerStats& stats,
+               JournalSink* sink, WorkStealingPool* pool, TranspositionTable* table) {
+    Tracer::setThreadName("game");
+    std::unique_ptr<MovePolicy> policy = createPolicy(options, pool, table);
+    std::unique_ptr<LinesEngine> created = LinesEngine::create(options.rows, options.columns,
+                                                               options.rules);
+    LinesEngine& engine = *created;
+    MoveJournal journal;
+    long game;
+    while ((game = nextGame.fetch_add(1)) < options.games) {
+        uint64_t seed = options.seed + static_cast<uint64_t>(game);
+        engine.newGame(seed);
+        policy->seed(~seed);
+        if (sink)
+            journal.beginGame(engine);
+        Move move;
+        while (!engine.isFinal() && policy->chooseMove(engine, move)) {
+            engine.playTurn(move.from, move.to);
+            if (sink)
+                journal.recordTurn(engine, move);
+            ++stats.turns;
+        }
+        if (sink) {
+            std::lock_guard<std::mutex> lock(sink->mutex);
+            sink->file.write(reinterpret_cast<const char*>(journal.data().data()),
+                             static_cast<std::streamsize>(journal.data().size()));
+            journal.clearData();
+        }
+        GameResult result;
+        result.score = engine.score();
+        result.seed = seed;
+        stats.results.push_back(result);
+    }
+}
+
+/**
+ * @brief playBatches
+ * То же, что playGames, на пакете из options.batch полей: закончившееся поле сразу
+ * получает следующую партию, зерна партий и ходов - как у playGames со случайной стратегией
+ */
+void playBatches(const Options& options, std::atomic<long>& nextGame, WorkerStats& stats) {
+    Tracer::setThreadName("batch");
+    BatchEngine batch(options.batch, options.rows, options.columns, options.rules);
+    std::vector<long> games(batch.boards(), -1);
+    std::vector<Move> moves(batch.boards());
+    int active = 0;
+    for (int board = 0; board < batch.boards(); ++board) {
+        long game = nextGame.fetch_add(1);
+        if (game >= options.games)
+            break;
+        uint64_t seed = options.seed + static_cast<uint64_t>(game);
+        batch.newGame(board, seed);
+        batch.seedPolicy(board, ~seed);
+        games[board] = game;
+        ++active;
+    }
+    while (active > 0) {
+        batch.chooseRandomMoves(moves.data());
+        for (int board = 0; board < batch.boards(); ++board) {
+            if (games[board] < 0 || moves[board].from >= 0)
+                continue;
+            GameResult result;
+            result.score = batch.score(board);
+            result.seed = options.seed + static_cast<uint64_t>(games[board]);
+            stats.results.push_back(result);
+            long game = nextGame.fetch_add(1);
+            if (game >= options.games) {
+                games[board] = -1;
+                --active;
+                continue;
+            }
+            uint64_t seed = options.seed + static_cast<uint64_t>(game);
+            batch.newGame(board, seed);
+            batch.seedPolicy(board, ~seed);
+            games[board] = game;
+        }
+        stats.turns += batch.playTurns(moves.data());
+    }
+}
+
+/**
+ * @brief sameBoard
+ * * @return true, если поле пакета совпадает с движком вплоть до порядка свободных ячеек и генератора
+ */
+bool sameBoard(const BatchEngine& batch, int board, const LinesEngine& engine) {
+    if (batch.score(board) != engine.score() || batch.freeCount(board) != engine.freeCount() ||
+            batch.isFinal(board) != engine.isFinal() || batch.randomState(board) != engine.randomState())
+        return false;
+    for (int i = 0; i < engine.cells(); ++i)
+        if (batch.isBusy(board, i) != engine.isBusy(i) || batch.colorAt(board, i) != engine.colorAt(i))
+            return false;
+    for (int n = 0; n < engine.freeCount(); ++n)
+        if (batch.freeCellAt(board, n) != engine.freeCellAt(n))
+            return false;
+    return true;
+}
+
+/**
+ * @brief verifyBatches
+ * Играет options.games партий одновременно на пакете и на отдельных движках теми же ходами
+ * и сравнивает поля после каждого хода
+ * * @return код завершения: 0 - расхождений нет
+ */
+int verifyBatches(const Options& options) {
+    const int boards = options.batch > 0 ? options.batch : 64;
+    BatchEngine batch(boards, options.rows, options.columns, options.rules);
+    std::vector<std::unique_ptr<LinesEngine> > engines(boards);
+    std::vector<long> games(boards, -1);
+    std::vector<long> turnOf(boards, 0);
+    std::vector<Move> moves(boards);
+    std::vector<Move> legal;
+    long nextGame = 0;
+    long turns = 0;
+    int active = 0;
+
+    auto start = [&](int board) {
+        if (nextGame >= options.games) {
+            games[board] = -1;
+            return false;
+        }
+        uint64_t seed = options.seed + static_cast<uint64_t>(nextGame);
+        batch.newGame(board, seed);
+        batch.seedPolicy(board, ~seed);
+        if (!engines[board])
+            engines[board] = LinesEngine::create(options.rows, options.columns, options.rules);
+        engines[board]->newGame(seed);
+        games[board] = nextGame++;
+        turnOf[board] = 0;
+        return true;
+    };
+    auto report = [&](int board, const char* what) {
+        std::fprintf(stderr, "MISMATCH: %s  game seed: %llu  turn: %ld\n", what,
+                     static_cast<unsigned long long>(options.seed + static_cast<uint64_t>(games[board])),
+                     turnOf[board]);
+        return 1;
+    };
+
+    for (int board = 0; board < boards; ++board) {
+        if (!start(board))
+            break;
+        if (!sameBoard(batch, board, *engines[board]))
+            return report(board, "new game");
+        ++active;
+    }
+    while (active > 0) {
+        batch.chooseRandomMoves(moves.data());
+        for (int board = 0; board < boards; ++board) {
+            if (games[board] < 0 || moves[board].from >= 0)
+                continue;
+            engines[board]->legalMoves(legal);
+            if (!engines[board]->isFinal() && !legal.empty())
+                return report(board, "batch found no move");
+            if (start(board)) {
+                if (!sameBoard(batch, board, *engines[board]))
+                    return report(board, "new game");
+            } else {
+                --active;
+            }
+        }
+        turns += batch.playTurns(moves.data());
+        for (int board = 0; board < boards; ++board) {
+            if (games[board] < 0 || moves[board].from < 0)
+                continue;
+            if (!engines[board]->playTurn(moves[board].from, moves[board].to))
+                return report(board, "move rejected by the engine");
+            ++turnOf[board];
+            if (!sameBoard(batch, board, *engines[board]))
+                return report(board, "boards differ");
+        }
+    }
+    std::printf("verify: board: %dx%d  games: %ld  turns: %ld  batch: %d  mismatches: 0\n",
+                options.rows, options.columns, nextGame, turns, boards);
+    return 0;
+}
+
+/**
+ * @brief sameEngine
+ * Цвет свободных ячеек не сравнивается: снятая фигура оставляет его в ячейке
+ * для анимации исчезновения, и он зависит от того, как ячейка освободилась
+ * * @return true, если движки совпадают вплоть до порядка свободных ячеек и генератора
+ */
+bool sameEngine(const LinesEngine& a, const LinesEngine& b) {
+    if (a.score() != b.score() || a.freeCount() != b.freeCount() || a.randomState() != b.randomState())
+        return false;
+    for (int i = 0; i < a.cells(); ++i)
+        if (a.isBusy(i) != b.isBusy(i) || (a.isBusy(i) && a.colorAt(i) != b.colorAt(i)))
+            return false;
+    for (int n = 0; n < a.freeCount(); ++n)
+        if (a.freeCellAt(n) != b.freeCellAt(n))
+            return false;
+    return true;
+}
+
+/**
+ * @brief verifyTurns
+ * Играет партии так же, как приложение: ход разыгрывается на копии движка с записью
+ * в собственную историю (TurnWorker), затем переносится на движок партии как TurnDelta -
+ * сначала перемещение, потом остальное (GameBoard). Каждый седьмой ход после перемещения
+ * прерывается abortTurn и применяется заново. Итог сравнивается с тем же ходом через
+ * playTurn, а каждые пять ходов и в конце партии - еще и отмена с повтором.
+ * Ходы, отмены и повторы пишутся в журнал, как это делает модель, и в конце партии
+ * журнал перематывается в отдельный движок, который должен совпасть с движком партии
+ * * @return код завершения: 0 - расхождений нет
+ */
+int verifyTurns(const Options& options) {
+    std::unique_ptr<MovePolicy> policy = createPolicy(options, nullptr, nullptr);
+    long turns = 0;
+    uint64_t seed = options.seed;
+    long turn = 0;
+    auto report = [&](const char* what) {
+        std::fprintf(stderr, "MISMATCH: %s  game seed: %llu  turn: %ld\n", what,
+                     static_cast<unsigned long long>(seed), turn);
+        return 1;
+    };
+
+    for (long game = 0; game < options.games; ++game) {
+        seed = options.seed + static_cast<uint64_t>(game);
+        std::unique_ptr<LinesEngine> engine = LinesEngine::create(options.rows, options.columns, options.rules);
+        engine->newGame(seed);
+        std::unique_ptr<LinesEngine> reference = engine->clone();
+        UndoStack history;
+        UndoStack referenceHistory;
+        reference->setListener(&referenceHistory);
+        MoveJournal journal;
+        journal.beginGame(*engine);
+        policy->seed(~seed);
+        Move move;
+        for (turn = 0; !engine->isFinal() && policy->chooseMove(*engine, move); ++turn) {
+            std::unique_ptr<LinesEngine> position = engine->clone();
+            UndoStack recorder;
+            std::vector<int> path;
+            position->setListener(&recorder);
+            if (position->shortestPath(move.from, move.to, path) <= 0)
+                return report("no path for a legal move");
+            recorder.beginTurn(*position);
+            position->moveAlong(path);
+            TurnDelta delta;
+            const int moveChanges = recorder.recordedChanges();
+            position->endTurn(move.to);
+            recorder.endTurn(*position);
+            recorder.lastTurn(delta);
+            delta.moveChanges = size_t(moveChanges);
+
+            if (turn % 7 == 3) {
+                std::unique_ptr<LinesEngine> before = engine->clone();
+                history.beginTurn(*engine);
+                history.applyChanges(*engine, delta, 0, delta.moveChanges);
+                history.abortTurn(*engine);
+                if (!sameEngine(*engine, *before) || history.isRecording())
+                    return report("aborted turn was not rolled back");
+            }
+            history.beginTurn(*engine);
+            history.applyChanges(*engine, delta, 0, delta.moveChanges);
+            if (!engine->isBusy(move.to) || engine->isBusy(move.from))
+                return report("move phase did not move the piece");
+            history.applyChanges(*engine, delta, delta.moveChanges, delta.changes.size());
+            engine->setScore(delta.scoreAfter);
+            engine->restoreRandom(engine->seed(), delta.randomAfter);
+            engine->setSpawned(delta.spawned);
+            history.endTurn(*engine);
+            journal.recordTurn(*engine, move);
+
+            referenceHistory.beginTurn(*reference);
+            if (!reference->playTurn(move.from, move.to))
+                return report("move rejected by playTurn");
+            referenceHistory.endTurn(*reference);
+            if (!sameEngine(*engine, *reference) || !sameEngine(*engine, *position))
+                return report("delta differs from playTurn");
+            ++turns;
+
+            if (turn % 5 == 4) {
+                if (!history.undo(*engine) || !referenceHistory.undo(*reference) ||
+                        !sameEngine(*engine, *reference))
+                    return report("undo differs");
+                journal.recordUndo(*engine);
+                if (!history.redo(*engine) || !referenceHistory.redo(*reference) ||
+                        !sameEngine(*engine, *reference))
+                    return report("redo differs");
+                journal.recordRedo(*engine);
+            }
+        }
+        std::unique_ptr<LinesEngine> replayed = LinesEngine::create(options.rows, options.columns, options.rules);
+        UndoStack replayedHistory;
+        const std::vector<uint8_t>& data = journal.data();
+        if (MoveJournal::replay(data.data(), data.size(), INT_MAX, *replayed, &replayedHistory) < 0 ||
+                !sameEngine(*replayed, *engine) || replayedHistory.undoCount() != history.undoCount())
+            return report("journal replay differs");
+        while (history.canUndo()) {
+            if (!history.undo(*engine) || !referenceHistory.undo(*reference) || !sameEngine(*engine, *reference))
+                return report("undo to the start differs");
+        }
+    }
+    std::printf("verify-turns: board: %dx%d  games: %ld  turns: %ld  mismatches: 0\n",
+                options.rows, options.columns, options.games, turns);
+    return 0;
+}
+
+int percentile(const std::vector<GameResult>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index].score;
+}
+
+void printReport(const Options& options, int threads, double seconds, std::vector<GameResult>& results, long turns) {
+    std::sort(results.begin(), results.end());
+    double sum = 0;
+    for (const GameResult& result : results)
+        sum += result.score;
+    int minScore = results.front().score;
+    int maxScore = results.back().score;
+    std::printf("policy: %s  board: %dx%d  games: %zu  threads: %d  seed: %llu\n", options.policy.c_str(),
+                options.rows, options.columns, results.size(), threads,
+                static_cast<unsigned long long>(options.seed));
+    std::printf("elapsed: %.3f s  games/sec: %.1f  turns/sec: %.1f\n",
+                seconds, results.size() / seconds, turns / seconds);
+    std::printf("score: min %d  mean %.1f  p50 %d  p90 %d  p99 %d  max %d\n",
+                minScore, sum / results.size(), percentile(results, 0.5),
+                percentile(results, 0.9), percentile(results, 0.99), maxScore);
+    std::printf("worst game seed: %llu  best game seed: %llu\n",
+                static_cast<unsigned long long>(results.front().seed),
+                static_cast<unsigned long long>(results.back().seed));
+
+    const int buckets = 10;
+    int width = std::max(1, (maxScore - minScore) / buckets + 1);
+    std::vector<long> histogram(buckets, 0);
+    for (const GameResult& result : results)
+        ++histogram[std::min(buckets - 1, (result.score - minScore) / width)];
+    for (int i = 0; i < buckets; ++i) {
+        int from = minScore + i * width;
+        std::printf("  [%6d, %6d) %ld\n", from, from + width, histogram[i]);
+    }
+}
+
+/**
+ * @brief replayJournal
+ * Перематывает до конца все партии журнала и печатает скорость воспроизведения
+ */
+int replayJournal(const Options& options) {
+    std::ifstream file(options.replay, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "ERROR: cannot open %s\n", options.replay.c_str());
+        return 1;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<size_t> games = MoveJournal::findGames(data.data(), data.size());
+    std::unique_ptr<LinesEngine> engine;
+    long moves = 0;
+    long broken = 0;
+    long long scores = 0;
+    for (size_t i = 0; i < games.size(); ++i) {
+        size_t end = i + 1 < games.size() ? games[i + 1] : data.size();
+        uint64_t seed;
+        int rows, columns;
+        if (!MoveJournal::readGame(data.data() + games[i], end - games[i], seed, rows, columns)) {
+            ++broken;
+            continue;
+        }
+        if (!engine || engine->rows() != rows || engine->columns() != columns)
+            engine = LinesEngine::create(rows, columns, options.rules);
+        int reached = engine ? MoveJournal::replay(data.data() + games[i], end - games[i], INT_MAX, *engine)
+                             : -1;
+        if (reached < 0) {
+            ++broken;
+            continue;
+        }
+        moves += reached;
+        scores += engine->score();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::printf("journal: %s  bytes: %zu  games: %zu  broken: %ld\n",
+                options.replay.c_str(), data.size(), games.size(), broken);
+    std::printf("elapsed: %.3f s  games/sec: %.1f  moves/sec: %.1f  total score: %lld\n",
+                seconds, games.size() / seconds, moves / seconds, scores);
+    return broken ? 1 : 0;
+}
+
+/**
+ * @brief selectScanKernel
+ * * @return false, если реализации с таким именем нет или процессор ее не поддерживает
+ */
+bool selectScanKernel(const std::string& name) {
+    const LineScan::Kernel kernels[] = {LineScan::PORTABLE, LineScan::SSE2, LineScan::AVX2};
+    for (LineScan::Kernel kernel : kernels)
+        if (name == LineScan::kernelName(kernel))
+            return LineScan::setKernel(kernel);
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!options.trace.empty())
+        Tracer::setEnabled(true);
+    if (!options.scanKernel.empty() && !selectScanKernel(options.scanKernel)) {
+        std::fprintf(stderr, "ERROR: scan kernel %s is not supported\n", options.scanKernel.c_str());
+        return 1;
+    }
+    if (options.verifyTurns)
+        return verifyTurns(options);
+    if (options.verify)
+        return verifyBatches(options);
+    if (!options.replay.empty()) {
+        int result = replayJournal(options);
+        if (!options.trace.empty() && !Tracer::writeChromeTrace(options.trace))
+            std::fprintf(stderr, "ERROR: cannot write %s\n", options.trace.c_str());
+        return result;
+    }
+
+    std::unique_ptr<JournalSink> sink;
+    if (!options.journal.empty()) {
+        sink.reset(new JournalSink());
+        sink->file.open(options.journal, std::ios::binary | std::ios::app);
+        if (!sink->file) {
+            std::fprintf(stderr, "ERROR: cannot open %s\n", options.journal.c_str());
+            return 1;
+        }
+    }
+    // подсказка сама занимает все ядра, поэтому по умолчанию партии играются по одной
+    std::unique_ptr<WorkStealingPool> pool;
+    std::unique_ptr<TranspositionTable> table;
+    if (options.policy == "hint" || options.policy == "expectimax")
+        pool.reset(new WorkStealingPool(options.searchThreads));
+    if (options.policy == "expectimax")
+        table.reset(new TranspositionTable(size_t(options.tableMb), options.replacement));
+    int threads = options.threads > 0 ? options.threads
+                                      : pool ? 1 : std::max(1u, std::thread::hardware_concurrency());
+
+    std::atomic<long> nextGame(0);
+    std::vector<WorkerStats> stats(threads);
+    std::vector<std::thread> workers;
+
+    auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; ++i) {
+        if (options.batch > 0)
+            workers.emplace_back(playBatches, std::cref(options), std::ref(nextGame), std::ref(stats[i]));
+        else
+            workers.emplace_back(playGames, std::cref(options), std::ref(nextGame), std::ref(stats[i]),
+                                 sink.get(), pool.get(), table.get());
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::vector<GameResult> results;
+    long turns = 0;
+    for (const WorkerStats& worker : stats) {
+        results.insert(results.end(), worker.results.begin(), worker.results.end());
+        turns += worker.turns;
+    }
+    printReport(options, threads, seconds, results, turns);
+    if (!options.trace.empty() && !Tracer::writeChromeTrace(options.trace))
+        std::fprintf(stderr, "ERROR: cannot write %s\n", options.trace.c_str());
+    if (table)
+        std::printf("table: %zu entries  %zu MB  probes: %llu  hits: %llu\n", table->capacity(),
+                    table->memoryBytes() / (1024 * 1024), static_cast<unsigned long long>(table->probes()),
+                    static_cast<unsigned long long>(table->hits()));
+    return 0;
+}
@@ -0,0 +1,10 @@
+TEMPLATE = app
+TARGET   = selfplay
+
+CONFIG += console c++11 thread
+CONFIG -= app_bundle qt
+
+SOURCES += \
+        main.cpp
+
+include(../engine/engine.pri)